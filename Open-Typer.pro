@@ -5,3 +5,22 @@ SUBDIRS += \
     libcore
 
 app.depends = libcore
+
+# Compiles built-in packs at build time (see app/app.pro)
+!wasm:!cross_compile {
+	SUBDIRS += pack-compiler
+	pack-compiler.depends = libcore
+	app.depends += pack-compiler
+}
+
+# Grades typed submissions from the command line
+!wasm {
+	SUBDIRS += grader
+	grader.depends = libcore
+}
+
+# Unit tests and benchmarks (run with make check)
+!wasm {
+	SUBDIRS += tests
+	tests.depends = libcore
+}
@@ -55,12 +55,14 @@ SOURCES += \
     src/options/KeyboardOptions.cpp \
     src/options/OptionsWindow.cpp \
     src/packEditor/PackEditor.cpp \
+    src/packEditor/PackDocument.cpp \
     src/packEditor/PackSelector.cpp \
     src/updater/Updater.cpp \
     src/main.cpp \
     src/MainWindow.cpp \
     src/updater/UpdaterQuestion.cpp \
     src/widgets/InputLabelWidget.cpp \
+    src/widgets/KeyboardView.cpp \
     src/widgets/LanguageList.cpp \
     src/widgets/KeyboardWidget.cpp
 
@@ -73,11 +75,13 @@ HEADERS += \
     src/include/options/KeyboardOptions.h \
     src/include/options/OptionsWindow.h \
     src/include/packEditor/PackEditor.h \
+    src/include/packEditor/PackDocument.h \
     src/include/packEditor/PackSelector.h \
     src/include/updater/Updater.h \
     src/include/updater/UpdaterQuestion.h \
     src/include/MainWindow.h \
     src/include/widgets/InputLabelWidget.h \
+    src/include/widgets/KeyboardView.h \
     src/include/widgets/LanguageList.h \
     src/include/widgets/KeyboardWidget.h
 
@@ -108,6 +112,36 @@ RESOURCES += \
     dark-theme/dark-style.qrc \
     light-theme/light-style.qrc
 
+# Compiled built-in packs (see CompiledPack)
+# The packs are compiled by pack-compiler and embedded in a generated resource file.
+!wasm:!cross_compile {
+	win32 {
+		PACK_COMPILER = $$shell_path($$PWD/../pack-compiler.exe)
+	} else:macx {
+		PACK_COMPILER = DYLD_LIBRARY_PATH=$$shell_path($$PWD/..) $$shell_path($$PWD/../pack-compiler)
+	} else {
+		PACK_COMPILER = LD_LIBRARY_PATH=$$shell_path($$PWD/..) $$shell_path($$PWD/../pack-compiler)
+	}
+	BUILT_IN_PACKS = $$files($$PWD/res/configs/*)
+	mkpath($$OUT_PWD/res/compiled-configs)
+	packCompiler.input = BUILT_IN_PACKS
+	packCompiler.output = $$OUT_PWD/res/compiled-configs/${QMAKE_FILE_BASE}
+	packCompiler.commands = $$PACK_COMPILER ${QMAKE_FILE_IN} ${QMAKE_FILE_OUT}
+	packCompiler.CONFIG += no_link target_predeps
+	QMAKE_EXTRA_COMPILERS += packCompiler
+	COMPILED_PACKS_QRC = $$OUT_PWD/compiled-configs.qrc
+	COMPILED_PACKS_QRC_CONTENT = "<RCC>" "    <qresource prefix=\"/\">"
+	for(pack, BUILT_IN_PACKS) {
+		packName = $$basename(pack)
+		# Compression would prevent mapping the packs without copying
+		COMPILED_PACKS_QRC_CONTENT += "        <file compression-algorithm=\"none\">res/compiled-configs/$${packName}</file>"
+		rcc.depends += $$OUT_PWD/res/compiled-configs/$${packName}
+	}
+	COMPILED_PACKS_QRC_CONTENT += "    </qresource>" "</RCC>"
+	write_file($$COMPILED_PACKS_QRC, COMPILED_PACKS_QRC_CONTENT)
+	RESOURCES += $$COMPILED_PACKS_QRC
+}
+
 win32:RC_ICONS += res/images/icon.ico
 
 # Third-party
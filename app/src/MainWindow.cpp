@@ -33,18 +33,16 @@ MainWindow::MainWindow(QWidget *parent) :
 	ui(new Ui::MainWindow)
 {
 	ui->setupUi(this);
-	QGridLayout *inputLabelLayout = new QGridLayout(ui->inputLabel);
-	ui->mistakeLabel->setHorizontalAdjust(false);
-	ui->mistakeLabel->setParent(ui->inputLabel);
-	inputLabelLayout->addWidget(ui->mistakeLabel);
-	inputLabelLayout->setContentsMargins(0, 0, 0, 0);
-	inputLabelLayout->setAlignment(ui->mistakeLabel, Qt::AlignLeft | Qt::AlignTop);
+	ui->inputLabel->setCorrectionColor(QColor(215, 71, 15));
 	QVBoxLayout *remainingTextAreaLayout = new QVBoxLayout(ui->remainingTextArea);
 	ui->keyboardFrame->setParent(ui->remainingTextArea);
 	remainingTextAreaLayout->addWidget(ui->keyboardFrame);
 	remainingTextAreaLayout->setAlignment(ui->keyboardFrame, Qt::AlignHCenter | Qt::AlignBottom);
 	ui->levelCurrentLineLabel->toggleScrolling(false);
 	ui->levelLabel->toggleScrolling(false);
+	// The text font is always fixed-pitch (see ThemeEngine#font())
+	ui->levelCurrentLineLabel->setFixedPitchSizing(true);
+	ui->levelLabel->setFixedPitchSizing(true);
 	localThemeEngine.setParent(this);
 	oldConfigName = "";
 	errorWords.clear();
@@ -140,6 +138,18 @@ MainWindow::MainWindow(QWidget *parent) :
 	// Addon API
 	connect(AddonApi::instance(), &AddonApi::changeMode, this, &MainWindow::changeMode);
 	connect(AddonApi::instance(), &AddonApi::startTypingTest, this, &MainWindow::initTest);
+	// Pack loader
+	connect(&packLoader, &PackLoader::lessonsDiscovered, this, &MainWindow::addLessons);
+	connect(&packLoader, &PackLoader::finished, this, [this]() {
+		if(packLoader.parser()->lessonCount() == 0)
+			addLessons(1, 0);
+		else if(parser == packLoader.parser())
+		{
+			// The pack can be opened again without loading it
+			PackRegistry::insert(packLoader.fileName(), parser);
+			packFromContent = false;
+		}
+	});
 	// Theme
 	if(Settings::containsWindowState() && Settings::containsWindowGeometry())
 	{
@@ -413,10 +423,11 @@ void MainWindow::refreshAll(void)
 }
 
 /*!
- * Opens a pack file using ConfigParser and returns the file name of the pack file.
+ * Opens a pack file using PackRegistry and returns the file name of the pack file.
  * \param[in] configName If there's a custom pack opened, configName represents the absolute path to the pack. Otherwise, it represents the built-in pack name.
  * \param[in] packContent If it's not empty, a QBuffer with pack content is created and ConfigParser treats it as a regular file.
  * \see ConfigParser
+ * \see PackRegistry
  */
 QString MainWindow::loadConfig(QString configName, QByteArray packContent)
 {
@@ -425,27 +436,35 @@ QString MainWindow::loadConfig(QString configName, QByteArray packContent)
 	if(customConfig)
 		configPath = configName;
 	else
-		configPath = ":/res/configs/" + configName;
+		configPath = BuiltInPacks::packPath(configName);
 	// Open selected config
-	if(!parser.bufferOpened())
-		parser.close();
 	if(packContent == "")
 	{
-		bool bufferOpened = parser.bufferOpened();
-		bool openSuccess;
-		if(bufferOpened && customConfig)
-			openSuccess = true;
-		else
-			openSuccess = parser.open(configPath);
-		if(!openSuccess && !bufferOpened)
+		// Keep the pack loaded from content
+		if(!packFromContent || !customConfig)
 		{
-			Settings::setLessonPack("");
-			refreshAll();
-			return QString();
+			// The pack is usually indexed in the background when the application starts
+			QSharedPointer<ConfigParser> pack = PackRegistry::pack(configPath);
+			if(!pack)
+			{
+				Settings::setLessonPack("");
+				refreshAll();
+				return QString();
+			}
+			packLoader.cancel();
+			parser = pack;
+			packFromContent = false;
+			if(customConfig)
+				PackRegistry::addRecentPack(configPath);
 		}
 	}
 	else
-		parser.loadToBuffer(packContent);
+	{
+		packLoader.cancel();
+		parser = QSharedPointer<ConfigParser>::create();
+		parser->loadToBuffer(packContent);
+		packFromContent = true;
+	}
 	// Update lessonSelectionList widget
 	updateLessonList();
 	if(customConfig)
@@ -476,7 +495,7 @@ void MainWindow::startLevel(int lessonID, int sublessonID, int levelID)
 	// Update selected lesson
 	ui->lessonSelectionList->setCurrentIndex(lessonID - 1);
 	// Get sublesson count
-	sublessonCount = parser.sublessonCount(lessonID);
+	sublessonCount = parser->sublessonCount(lessonID);
 	// Check if -1 (last sublesson in current lesson) was passed
 	if(sublessonID == -1)
 		sublessonID = sublessonCount;
@@ -485,21 +504,21 @@ void MainWindow::startLevel(int lessonID, int sublessonID, int levelID)
 	loadLesson(lessonID, sublessonID);
 	// Check if -1 (last level in current sublesson) was passed
 	if(levelID == -1)
-		levelID = parser.exerciseCount(lessonID, sublessonID + sublessonListStart);
+		levelID = parser->exerciseCount(lessonID, sublessonID + sublessonListStart);
 	// Load length extension
 	if(!customLevelLoaded)
-		levelLengthExtension = parser.exerciseLineLength(lessonID, sublessonID + sublessonListStart, levelID);
+		levelLengthExtension = parser->exerciseLineLength(lessonID, sublessonID + sublessonListStart, levelID);
 	// Load level text
 	if(customLevelLoaded)
 		level = customLevel;
 	else
-		level = parser.exerciseText(lessonID,
+		level = parser->exerciseText(lessonID,
 			sublessonID + sublessonListStart,
 			levelID);
 	// Get lesson count
-	lessonCount = parser.lessonCount();
+	lessonCount = parser->lessonCount();
 	// Get level count (in current lesson)
-	levelCount = parser.exerciseCount(lessonID, sublessonID + sublessonListStart);
+	levelCount = parser->exerciseCount(lessonID, sublessonID + sublessonListStart);
 	// Update level list
 	loadSublesson(levelID);
 	// Make lesson, sublesson and level info public
@@ -516,12 +535,18 @@ void MainWindow::startLevel(int lessonID, int sublessonID, int levelID)
 void MainWindow::updateLessonList(void)
 {
 	ui->lessonSelectionList->clear();
+	appendLessons(parser->lessonCount());
+}
+
+/*! Adds lessons, which aren't in the list of lessons yet, up to lastLesson. */
+void MainWindow::appendLessons(int lastLesson)
+{
 	QStringList lessons;
 	QString _lessonDesc;
-	int i, count = parser.lessonCount();
-	for(i = 1; i <= count; i++)
+	int i;
+	for(i = ui->lessonSelectionList->count() + 1; i <= lastLesson; i++)
 	{
-		_lessonDesc = ConfigParser::parseDesc(parser.lessonDesc(i));
+		_lessonDesc = ConfigParser::parseDesc(parser->lessonDesc(i));
 		if(_lessonDesc == "")
 			lessons += ConfigParser::lessonTr(i);
 		else
@@ -540,7 +565,7 @@ void MainWindow::loadLesson(int lessonID, int sublessonID)
 	int i, i2 = 0;
 	for(i = 1; i <= sublessonCount + i2; i++)
 	{
-		if(parser.exerciseCount(lessonID, i) > 0)
+		if(parser->exerciseCount(lessonID, i) > 0)
 			sublessons += ConfigParser::sublessonName(i);
 		else
 		{
@@ -578,6 +603,8 @@ void MainWindow::levelFinalInit(void)
 	publicPos::currentExercise = currentLevel;
 	if(currentMode == 1)
 		level += '\n';
+	// Error words are looked up in this table, so the text doesn't have to be searched on every mistake
+	levelTokens.setText(level);
 	ui->exerciseChecksFrame->setEnabled(true);
 	preview = false;
 	currentLine = 0;
@@ -594,18 +621,15 @@ void MainWindow::levelFinalInit(void)
 	lastTime = 0;
 	mistake = false;
 	ignoreMistakeLabelAppend = false;
-	mistakeTextHtml = "";
-	mistakeLabelHtml = "";
-	ui->mistakeLabel->setHtml(mistakeLabelHtml);
+	mistakeText = "";
+	mistakeLabelText = "";
 	ui->currentTimeNumber->setText("0");
 	ui->currentMistakesNumber->setText("0");
 	ui->closeCustomExButton->setVisible(customLevelLoaded);
 	// Init level input
 	input = "";
-	inputTextHtml = "";
 	displayInput = "";
-	ui->inputLabel->setAcceptRichText(true);
-	ui->inputLabel->setHtml(displayInput);
+	updateInputSurface(displayInput, "", mistakeLabelText);
 	updateText();
 	// Enable/disable stats
 	bool enableStats = !customLevelLoaded && !customConfig && (currentMode == 0);
@@ -622,42 +646,32 @@ void MainWindow::levelFinalInit(void)
 void MainWindow::updateText(void)
 {
 	ui->currentLineArea->show();
+	ui->inputLabel->setCorrectionsVisible(false);
 	ui->inputLabel->setFocusPolicy(Qt::StrongFocus);
 	ui->typingSpace->setFocusPolicy(Qt::NoFocus);
 	ui->typingSpace->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 	ui->textSeparationLine->show();
 	ui->remainingTextArea->show();
 	ui->exportButton->hide();
-	displayLevel = ConfigParser::initExercise(level, levelLengthExtension);
-	lineCount = displayLevel.count('\n');
-	// Process exercise text
-	QString level_ = level;
-	if(currentMode == 1)
-		level_ = level.left(level.count() - 1);
-	finalDisplayLevel = ConfigParser::initExercise(level_, levelLengthExtension, false, currentLine);
+	// Timed exercises have a new line at the end (see levelFinalInit())
+	if(!customLevelLoaded && (currentMode == 0))
+		levelLayout.setWrappedText(parser->wrappedExerciseText(currentLesson, currentAbsoluteSublesson, currentLevel, levelLengthExtension));
+	else
+		levelLayout.setText(level, levelLengthExtension);
+	displayLevel = levelLayout.text();
+	lineCount = levelLayout.lineCount() - 1;
+	// Process exercise text (the text is wrapped only if it has changed)
+	WrapLayout *textLayout = &levelLayout;
 	if(currentMode == 1)
-		finalDisplayLevel += "\n" + displayLevel.left(displayLevel.count() - 1).repeated(100 / lineCount);
-	QString currentLineText = "";
-	QString remainingText = "";
-	int i, line = 0;
-	for(i = 0; i < finalDisplayLevel.count(); i++)
 	{
-		remainingText += finalDisplayLevel[i];
-		if((finalDisplayLevel[i] == '\n') || (i + 1 >= finalDisplayLevel.count()))
-		{
-			if(line == 0)
-			{
-				currentLineText = remainingText;
-				remainingText = "";
-				if(currentLineText[currentLineText.count() - 1] == '\n')
-					currentLineText.remove(currentLineText.count() - 1, 1);
-			}
-			line++;
-		}
+		// The text is repeated after the last line, but the repeated text isn't created
+		timedLevelLayout.setText(level.left(level.count() - 1), levelLengthExtension);
+		timedLevelLayout.setRepeatedText(displayLevel.left(displayLevel.count() - 1), 100 / lineCount);
+		textLayout = &timedLevelLayout;
 	}
-	ui->levelCurrentLineLabel->setText(currentLineText);
+	ui->levelCurrentLineLabel->setText(textLayout->line(currentLine));
 	ui->centralwidget->layout()->activate();
-	ui->levelLabel->setText(remainingText);
+	ui->levelLabel->setText(textLayout->window(currentLine + 1));
 	((QGraphicsOpacityEffect *) ui->levelLabel->graphicsEffect())->setOpacity(0.5);
 	updateFont();
 	if(ui->hideTextCheckBox->isChecked())
@@ -669,6 +683,39 @@ void MainWindow::updateText(void)
 	blockInput = false;
 }
 
+/*!
+ * Shows the typed text on inputLabel.\n
+ * errorText is the wrong character typed after the text, it's painted with the correction color.
+ * Each '_' in underlineText underlines the typed character at the same position (lines are separated by new lines).\n
+ * Only the changed lines are painted again (see TypingSurface#setLines()).
+ */
+void MainWindow::updateInputSurface(const QString text, const QString errorText, const QString underlineText)
+{
+	const QStringList textLines = QString(text + errorText).split('\n');
+	const QStringList underlineLines = underlineText.split('\n');
+	QVector<TypingSurface::Line> lines;
+	int pos = 0;
+	for(int i = 0; i < textLines.count(); i++)
+	{
+		TypingSurface::Line line;
+		line.text = textLines[i];
+		if(!errorText.isEmpty() && (pos + line.text.count() > text.count()))
+			line.mistakeColumn = std::max(0, (int) text.count() - pos);
+		if(i < underlineLines.count())
+		{
+			for(int j = 0; j < underlineLines[i].count(); j++)
+			{
+				if(underlineLines[i][j] == '_')
+					line.underlines += QPair<int, int>(j, 1);
+			}
+		}
+		lines += line;
+		pos += line.text.count() + 1;
+	}
+	ui->inputLabel->setLines(lines);
+	ui->inputLabel->setCursorPosition(lines.count() - 1, lines.last().text.count());
+}
+
 /*! Connected from repeatButton.\n
  * Resets currently selected exercise.
  * \see startLevel
@@ -921,6 +968,13 @@ void MainWindow::keyPress(QKeyEvent *event)
 	if((levelPos == 0) && !levelInProgress)
 	{
 		errorWords.clear();
+		if(ui->correctMistakesCheckBox->isChecked())
+			validator.stop();
+		else
+		{
+			bool timed = (currentMode == 1);
+			validator.start(displayLevel, Settings::mistakeLimit() ? Settings::mistakeChars() : 0, timed, timed ? QTime(0, 0, 0).secsTo(QTime(timedExHours, timedExMinutes, timedExSeconds)) : 0);
+		}
 		ui->exerciseChecksFrame->setEnabled(false);
 		levelTimer.start();
 		secLoop->start(500);
@@ -933,15 +987,13 @@ void MainWindow::keyPress(QKeyEvent *event)
 		keyText = "'";
 	if((event->key() == Qt::Key_Return) || (event->key() == Qt::Key_Enter))
 		keyText = "\n";
-	QString convertedKeyText = keyText.toHtmlEscaped().replace(" ", "&nbsp;");
-	convertedKeyText.replace(" ", "&nbsp;");
 	bool correctChar = ((((displayLevel[displayPos] == '\n') && ((event->key() == Qt::Key_Return) || (event->key() == Qt::Key_Enter) || (event->key() == Qt::Key_Space))) || ((displayLevel[displayPos] != '\n') && (keyText == level[levelPos]))) && !mistake);
 	if(correctChar || !ui->correctMistakesCheckBox->isChecked())
 	{
 		if(!mistake && ignoreMistakeLabelAppend)
 		{
-			mistakeLabelHtml += "_";
-			mistakeTextHtml += "_";
+			mistakeLabelText += "_";
+			mistakeText += "_";
 		}
 		if(event->key() == Qt::Key_Backspace)
 		{
@@ -968,22 +1020,20 @@ void MainWindow::keyPress(QKeyEvent *event)
 				absolutePos--;
 				linePos--;
 				recordedCharacters.remove(recordedCharacters.count() - 1);
+				validator.removeCharacter();
 			}
-			plainText = QTextDocumentFragment::fromHtml(inputTextHtml).toPlainText();
-			inputTextHtml = plainText.remove(plainText.count() - 1, 1).toHtmlEscaped().replace(" ", "&nbsp;");
-			inputTextHtml.replace("\n", "<br>");
+			else
+				validator.chopInput();
 		}
 		else
 		{
 			if((((keyText == "\n") || ((keyText == " ") && ui->correctMistakesCheckBox->isChecked())) && (displayLevel[displayPos] == '\n')) || (keyText == "\n"))
 			{
-				inputTextHtml += "<br>";
-				mistakeTextHtml += "<br>";
+				mistakeText += "\n";
 				displayInput = "";
 				linePos = 0;
-				mistakeLabelHtml = "";
+				mistakeLabelText = "";
 				keyText = "\n";
-				convertedKeyText = "";
 				currentLine++;
 				ignoreMistakeLabelAppend = false;
 				updateText();
@@ -996,16 +1046,8 @@ void MainWindow::keyPress(QKeyEvent *event)
 					linePos = -1;
 					deadKeys = 0;
 					mistake = false;
-					mistakeLabelHtml = "";
-					if(ui->hideTextCheckBox->isChecked())
-						ui->mistakeLabel->setHtml(mistakeTextHtml);
-					else
-						ui->mistakeLabel->setHtml(mistakeLabelHtml);
+					mistakeLabelText = "";
 					displayInput = "";
-					if(ui->hideTextCheckBox->isChecked())
-						ui->inputLabel->setHtml(input);
-					else
-						ui->inputLabel->setHtml(displayInput);
 				}
 			}
 			else
@@ -1014,15 +1056,14 @@ void MainWindow::keyPress(QKeyEvent *event)
 					ignoreMistakeLabelAppend = false;
 				else
 				{
-					QString mistakeLabelAppend = keyText == "\n" ? "<br>" : "&nbsp;";
-					mistakeTextHtml += mistakeLabelAppend;
-					mistakeLabelHtml += mistakeLabelAppend;
+					QString mistakeLabelAppend = keyText == "\n" ? "\n" : " ";
+					mistakeText += mistakeLabelAppend;
+					mistakeLabelText += mistakeLabelAppend;
 				}
 				displayInput += keyText;
 				linePos++;
 			}
 			input += keyText;
-			inputTextHtml += convertedKeyText;
 			levelPos++;
 			displayPos++;
 			absolutePos++;
@@ -1034,6 +1075,7 @@ void MainWindow::keyPress(QKeyEvent *event)
 			charHits += deadKeys;
 			totalHits += charHits;
 			recordedCharacters += QPair<QString, int>(keyText, charHits);
+			validator.addCharacter(keyText, charHits);
 			deadKeys = 0;
 		}
 	}
@@ -1052,73 +1094,55 @@ void MainWindow::keyPress(QKeyEvent *event)
 		{
 			if(!KeyboardUtils::isSpecialKey(event))
 			{
-				QList<QVariantMap> mistakesToRemove;
+				// Replace mistakes at this position
+				int count = 0;
 				for(int i = 0; i < recordedMistakes.count(); i++)
 				{
-					if(recordedMistakes[i]["pos"] == absolutePos)
-						mistakesToRemove += recordedMistakes[i];
+					if(recordedMistakes[i].pos == absolutePos)
+						continue;
+					if(count != i)
+						recordedMistakes[count] = recordedMistakes[i];
+					count++;
 				}
-				levelMistakes -= mistakesToRemove.count();
-				for(int i = 0; i < mistakesToRemove.count(); i++)
-					recordedMistakes.removeAll(mistakesToRemove[i]);
-				QVariantMap currentMistake;
-				currentMistake["pos"] = absolutePos;
-				currentMistake["previous"] = keyText;
-				currentMistake["type"] = "change";
+				levelMistakes -= recordedMistakes.count() - count;
+				recordedMistakes.resize(count);
+				Mistake currentMistake;
+				currentMistake.pos = absolutePos;
+				currentMistake.previous = keyText;
+				currentMistake.type = Mistake::Type_Change;
 				recordedMistakes += currentMistake;
-				QString errorAppend;
-				if(ignoreMistakeLabelAppend)
-				{
-					QTextCursor cursor = ui->mistakeLabel->textCursor();
-					cursor.deletePreviousChar();
-					ui->mistakeLabel->setTextCursor(cursor);
-				}
 				if(keyText == " ")
 					errorAppend = "_";
 				else if(keyText == "\n")
-					errorAppend = "↵<br>";
+					errorAppend = "↵\n";
 				else
-					errorAppend = convertedKeyText;
-				if(ui->hideTextCheckBox->isChecked())
-					ui->inputLabel->setHtml(input.toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "<br>") + "<span style='color: red;'>" + errorAppend + "</span>");
-				else
-					ui->inputLabel->setHtml(displayInput.toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "<br>") + "<span style='color: red;'>" + errorAppend + "</span>");
+					errorAppend = keyText;
 				levelMistakes++;
 				ui->currentMistakesNumber->setText(QString::number(levelMistakes));
 				mistake = true;
-				QString errorWord = StringUtils::wordAt(level, levelPos);
-				if((errorWord != "") && !errorWords.contains(errorWord))
-					errorWords += errorWord;
+				int errorWordIndex = levelTokens.wordAt(levelPos);
+				if(errorWordIndex != -1)
+				{
+					QString errorWord = levelTokens.wordText(errorWordIndex);
+					if(!errorWords.contains(errorWord))
+						errorWords += errorWord;
+				}
 				deadKeys = 0;
 			}
 		}
 	}
-	if(!mistake)
-	{
-		if(ui->hideTextCheckBox->isChecked())
-			ui->inputLabel->setHtml(input.toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "<br>"));
-		else
-			ui->inputLabel->setHtml(displayInput.toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "<br>"));
-	}
-	QString mistakeLabelFinal;
-	if(ui->hideTextCheckBox->isChecked())
-		mistakeLabelFinal = mistake ? mistakeTextHtml + "&nbsp;" : mistakeTextHtml;
-	else
-		mistakeLabelFinal = mistake ? mistakeLabelHtml + "&nbsp;" : mistakeLabelHtml;
+	QString underlineText = ui->hideTextCheckBox->isChecked() ? mistakeText : mistakeLabelText;
 	if(!mistake && ignoreMistakeLabelAppend)
-		mistakeLabelFinal += "_";
-	ui->mistakeLabel->setHtml(mistakeLabelFinal);
-	ui->mistakeLabel->setFixedWidth(ui->inputLabel->width());
-	if(mistake)
-		ui->mistakeLabel->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
-	else
-		ui->mistakeLabel->moveCursor(QTextCursor::StartOfLine, QTextCursor::MoveAnchor);
-	ui->inputLabel->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
+		underlineText += "_";
+	updateInputSurface(ui->hideTextCheckBox->isChecked() ? input : displayInput, mistake ? errorAppend : "", underlineText);
 	ui->typingSpace->ensureWidgetVisible(ui->inputLabel);
 	if(((displayPos >= displayLevel.count()) && ui->correctMistakesCheckBox->isChecked()) || (currentLine >= lineCount + 1))
 	{
 		if(currentLine >= lineCount + 1)
+		{
 			input.remove(input.count() - 1, 1);
+			validator.chopInput();
+		}
 		keyRelease(event);
 		lastTime = levelTimer.elapsed() / 1000;
 		lastTimeF = levelTimer.elapsed() / 1000.0;
@@ -1126,104 +1150,149 @@ void MainWindow::keyPress(QKeyEvent *event)
 	}
 }
 
-/*! Ends the exercise by (optionally) saving the results and showing the ExerciseSummary dialog. */
+/*!
+ * Ends the exercise. If mistake correction is disabled, the result of exercise validation is used.
+ * If it isn't available yet, a progress dialog is shown if it takes long.
+ * \see finishExercise()
+ */
 void MainWindow::endExercise(bool showNetHits, bool showGrossHits, bool showTotalHits, bool showTime, bool showMistakes)
 {
 	levelInProgress = false;
 	input.replace("‘", "'");
 	displayLevel.replace("‘", "'");
 	if(ui->correctMistakesCheckBox->isChecked())
+	{
 		input = StringUtils::addMistakes(input, &recordedMistakes);
-	else
+		finishExercise(showNetHits, showGrossHits, showTotalHits, showTime, showMistakes);
+		return;
+	}
+	// The exercise was validated while it was being typed (see BackgroundValidator)
+	// The exercise text, mistake limit and time limit were passed to the validator when the exercise started
+	// and every change of the input was passed to it in keyPress()
+	QFuture<BackgroundValidator::Result> future = validator.result();
+	validator.stop();
+	if(future.isFinished())
 	{
-		recordedMistakes = StringUtils::validateExercise(displayLevel, input, recordedCharacters, &totalHits, &levelMistakes, &errorWords, (currentMode == 1), lastTimeF);
-		netHits = std::max(0, totalHits - (levelMistakes * errorPenalty));
-		ui->currentMistakesNumber->setText(QString::number(levelMistakes));
+		applyValidationResult(future.result());
+		finishExercise(showNetHits, showGrossHits, showTotalHits, showTime, showMistakes);
+		return;
 	}
-	QMap<int, QVariantMap *> mistakesMap;
+	blockInput = true;
+	// The progress dialog isn't shown immediately, don't allow switching the exercise until the result is used
+	ui->controlFrame->setEnabled(false);
+	ui->menuBar->setEnabled(false);
+	QProgressDialog *progressDialog = new QProgressDialog(tr("Validating exercise..."), QString(), 0, 0, this);
+	progressDialog->setWindowModality(Qt::WindowModal);
+	progressDialog->setMinimumDuration(500);
+	QFutureWatcher<BackgroundValidator::Result> *watcher = new QFutureWatcher<BackgroundValidator::Result>(this);
+	connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, progressDialog, showNetHits, showGrossHits, showTotalHits, showTime, showMistakes]() {
+		applyValidationResult(watcher->result());
+		progressDialog->deleteLater();
+		watcher->deleteLater();
+		finishExercise(showNetHits, showGrossHits, showTotalHits, showTime, showMistakes);
+	});
+	watcher->setFuture(future);
+}
+
+/*! Uses the result of exercise validation. \see endExercise() */
+void MainWindow::applyValidationResult(const BackgroundValidator::Result &result)
+{
+	recordedMistakes = result.mistakes;
+	totalHits = result.totalHits;
+	levelMistakes = result.mistakeCount;
+	errorWords = result.errorWords;
+	netHits = std::max(0, totalHits - (levelMistakes * errorPenalty));
+	ui->currentMistakesNumber->setText(QString::number(levelMistakes));
+}
+
+/*! Finishes the exercise by (optionally) saving the results and showing the ExerciseSummary dialog. */
+void MainWindow::finishExercise(bool showNetHits, bool showGrossHits, bool showTotalHits, bool showTime, bool showMistakes)
+{
+	// Controls are disabled while the exercise is being validated (see endExercise())
+	if(!uiLocked)
+	{
+		ui->controlFrame->setEnabled(true);
+		ui->menuBar->setEnabled(true);
+	}
+	QMap<int, const Mistake *> mistakesMap;
 	for(int i = 0; i < recordedMistakes.count(); i++)
-		mistakesMap[recordedMistakes[i]["pos"].toInt()] = &recordedMistakes[i];
-	inputTextHtml = "";
+		mistakesMap[recordedMistakes[i].pos] = &recordedMistakes[i];
+	resultLines.clear();
 	QStringList lines = input.split("\n");
 	int pos = 0, delta = 0;
-	mistakeTextHtml = "";
 	for(int i = 0; i < lines.count(); i++)
 	{
-		QString addLine = lines[i].toHtmlEscaped().replace(" ", "&nbsp;");
-		inputTextHtml += "<span style=\"color: rgba(0, 0, 0, 0);\">" + addLine + "</span><br>";
-		// Add line with correct characters
+		TypingSurface::Line resultLine;
+		// Add line with correct characters above the typed line
 		int oldPos = pos;
 		int count = lines[i].count();
 		for(int j = 0; j <= lines[i].count(); j++)
 		{
 			QString inputChar;
 			if(j < count)
-				inputChar = QString(input[pos]).toHtmlEscaped().replace(" ", "&nbsp;");
+				inputChar = QString(input[pos]);
 			else
-				inputChar = "&nbsp;";
+				inputChar = " ";
 			if(mistakesMap.contains(pos))
 			{
 				QString correct;
 				if(ui->correctMistakesCheckBox->isChecked())
 					correct = displayLevel[(pos - delta) % (displayLevel.count() - 1)];
 				else
-					correct = mistakesMap[pos]->value("previous").toString();
-				QString type = mistakesMap[pos]->value("type").toString();
-				if(type == "deletion")
+					correct = mistakesMap[pos]->previous;
+				Mistake::Type type = mistakesMap[pos]->type;
+				if(type == Mistake::Type_Deletion)
 				{
-					mistakeTextHtml += correct.split("\n").at(0).toHtmlEscaped().replace(" ", "&nbsp;");
-					inputTextHtml += QString("&nbsp;").repeated(correct.split("\n").at(0).count());
+					resultLine.corrections += correct.split("\n").at(0);
+					resultLine.text += QString(" ").repeated(correct.split("\n").at(0).count());
 				}
 				else
-					mistakeTextHtml += correct.toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "&nbsp;");
-				if(type == "change")
+					resultLine.corrections += QString(correct).replace("\n", " ");
+				if(type == Mistake::Type_Change)
 				{
 					if(correct == "\n")
 						delta++;
 				}
 				else
-					mistakeTextHtml += "&nbsp;";
-				inputTextHtml += inputChar;
+					resultLine.corrections += " ";
+				resultLine.text += inputChar;
 			}
 			else if(j < count)
 			{
-				mistakeTextHtml += "<span style=\"color: rgba(0, 0, 0, 0);\">" + QString(input[pos]).toHtmlEscaped().replace(" ", "&nbsp;") + "</span>";
-				inputTextHtml += inputChar;
+				resultLine.corrections += " ";
+				resultLine.text += inputChar;
 			}
 			if(j < count)
 				pos++;
 		}
-		inputTextHtml += "<br>";
-		// Add line with underlined mistakes
-		mistakeTextHtml += "<br>";
+		// Underline mistakes
 		pos = oldPos;
+		int column = 0;
 		for(int j = 0; j <= count; j++)
 		{
-			QString append = "&nbsp;";
 			if(mistakesMap.contains(pos))
 			{
 				QString correct;
 				if(ui->correctMistakesCheckBox->isChecked())
 					correct = displayLevel[pos];
 				else
-					correct = mistakesMap[pos]->value("previous").toString();
-				if((mistakesMap[pos]->value("type").toString() == "deletion") && correct.contains("\n"))
-					mistakeTextHtml += "<u>&nbsp;";
+					correct = mistakesMap[pos]->previous;
+				int length;
+				if((mistakesMap[pos]->type == Mistake::Type_Deletion) && correct.contains("\n"))
+					length = 1;
 				else
-					mistakeTextHtml += "<u>" + QString("&nbsp;").repeated(std::max(1LL, (long long int) correct.count()));
+					length = std::max(1, (int) correct.count());
+				resultLine.underlines += QPair<int, int>(column, length);
+				column += length;
+				if(mistakesMap[pos]->type == Mistake::Type_Deletion)
+					column++;
 			}
 			else if(j < count)
-				mistakeTextHtml += "<span style=\"color: rgba(0, 0, 0, 0);\">" + QString(input[pos]).toHtmlEscaped().replace(" ", "&nbsp;") + "</span>";
-			if(mistakesMap.contains(pos))
-			{
-				mistakeTextHtml += "</u>";
-				if(mistakesMap[pos]->value("type").toString() == "deletion")
-					mistakeTextHtml += "&nbsp;";
-			}
+				column++;
 			if(j < count)
 				pos++;
 		}
-		mistakeTextHtml += "<br>";
+		resultLines += resultLine;
 		pos++;
 	}
 	netHits = std::max(0, totalHits - levelMistakes * Settings::errorPenalty());
@@ -1262,6 +1331,10 @@ void MainWindow::endExercise(bool showNetHits, bool showGrossHits, bool showTota
 			recordedCharactersList.append(record);
 		}
 		args["recordedCharacters"] = recordedCharactersList;
+		QList<QVariant> recordedMistakesList;
+		for(int i = 0; i < recordedMistakes.count(); i++)
+			recordedMistakesList.append(recordedMistakes[i].toVariantMap());
+		args["recordedMistakes"] = recordedMistakesList;
 		args["inputText"] = input;
 		args["time"] = lastTimeF;
 		AddonApi::sendEvent(IAddon::Event_EndTypingTest, args);
@@ -1288,13 +1361,10 @@ void MainWindow::endExercise(bool showNetHits, bool showGrossHits, bool showTota
 		ui->exerciseChecksFrame->setEnabled(false);
 		ui->exportButton->show();
 		preview = true;
-		// Load saved text
-		ui->inputLabel->setHtml(inputTextHtml);
-		ui->mistakeLabel->setHtml(mistakeTextHtml);
-		ui->mistakeLabel->setFixedWidth(ui->mistakeLabel->document()->size().width());
-		// Move cursor to the end
-		ui->mistakeLabel->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
-		ui->inputLabel->moveCursor(QTextCursor::End, QTextCursor::MoveAnchor);
+		// Show the typed text with mistakes
+		ui->inputLabel->setCorrectionsVisible(true);
+		ui->inputLabel->setLines(resultLines);
+		ui->inputLabel->setCursorPosition(-1, 0);
 		// Hide other widgets
 		ui->currentLineArea->hide();
 		ui->textSeparationLine->hide();
@@ -1404,13 +1474,11 @@ void MainWindow::loadTheme(void)
 void MainWindow::updateFont(void)
 {
 	QFont newFont = ThemeEngine::font();
-	QFont mistakeLabelFont = ThemeEngine::errorFont();
 	// Update labels
 	ui->levelCurrentLineLabel->setFont(newFont);
 	ui->levelLabel->setFont(newFont);
-	ui->inputLabel->setFont(newFont);
-	ui->mistakeLabel->setFont(mistakeLabelFont);
-	ui->mistakeLabel->setFixedWidth(ui->mistakeLabel->document()->size().width());
+	ui->inputLabel->setTextFont(newFont);
+	ui->inputLabel->setCorrectionFont(ThemeEngine::errorFont());
 	int scrollBarWidth = ui->typingSpace->verticalScrollBar()->size().width();
 	QTextDocument *tmpDoc = ui->levelCurrentLineLabel->document()->clone(this);
 	ui->currentLineArea->setFixedSize(tmpDoc->size().toSize() + QSize(scrollBarWidth, 0));
@@ -1419,12 +1487,12 @@ void MainWindow::updateFont(void)
 		std::max(tmpDoc->size().toSize().width() + 12,
 			ui->keyboardFrame->width() + 12)));
 	ui->typingSpace->setMinimumHeight(0);
-	ui->typingSpace->setMaximumHeight(ui->inputLabel->document()->size().height() * 2);
+	ui->typingSpace->setMaximumHeight(ui->inputLabel->sizeHint().height() * 2);
 	if(!preview)
 		ui->typingSpace->setMaximumWidth(QWIDGETSIZE_MAX);
 	else
 	{
-		ui->typingSpace->setFixedWidth(ui->inputLabel->document()->size().width() + scrollBarWidth * 2);
+		ui->typingSpace->setFixedWidth(ui->inputLabel->sizeHint().width() + scrollBarWidth * 2);
 		ui->typingSpace->setMaximumHeight(QWIDGETSIZE_MAX);
 	}
 }
@@ -1441,7 +1509,7 @@ void MainWindow::setColors(void)
 	// Set input text color
 	if(!ThemeEngine::customInputTextColor())
 		localThemeEngine.resetInputTextColor();
-	ui->inputLabel->setStyleSheet(ThemeEngine::inputTextStyleSheet());
+	ui->inputLabel->setTextColor(ThemeEngine::inputTextColor());
 	// Set background color
 	if(!ThemeEngine::customBgColor())
 		localThemeEngine.resetBgColor();
@@ -1493,32 +1561,72 @@ void MainWindow::openPack(void)
 	QFileDialog::getOpenFileContent(QString(), fileContentReady);
 #else
 	QString fileName = QFileDialog::getOpenFileName(this, QString(), QString(), tr("Open-Typer pack files") + " (*.typer)" + ";;" + tr("All files") + " (*)");
-	if(fileName != "")
+	if((fileName != "") && QFile::exists(fileName))
 	{
-		QFile file(fileName);
-		if(file.open(QIODevice::ReadOnly | QIODevice::Text))
-			fileContentReady(fileName, file.readAll());
+		// Large packs are loaded progressively, other packs are loaded by PackRegistry
+		if(QFileInfo(fileName).size() > PackLoader::streamingThreshold)
+			packLoader.load(fileName);
+		else
+			fileContentReady(fileName, QByteArray());
 	}
 #endif
 }
 
+/*!
+ * Connected from packLoader.lessonsDiscovered().\n
+ * Adds the loaded lessons to the list of lessons.
+ * The pack is opened as soon as the first lesson is loaded.
+ */
+void MainWindow::addLessons(int first, int last)
+{
+	if(first == 1)
+	{
+		customConfig = true;
+		Settings::setCustomLessonPack(customConfig);
+		parser = packLoader.parser();
+		packFromContent = true;
+		// Make sure the first exercise gets loaded
+		oldConfigName = "";
+		loadConfig(packLoader.fileName());
+		refreshAll();
+	}
+	else
+	{
+		appendLessons(last);
+		lessonCount = parser->lessonCount();
+	}
+}
+
 /*! Connected from openEditorButton.\n
  * Opens the editor.
  */
 void MainWindow::openEditor(void)
 {
-	// Close pack file
-	QString oldFileName = parser.fileName();
-	parser.close();
 	// Open editor
 	PackEditor *editorWindow;
 	editorWindow = new PackEditor(this);
 	editorWindow->setWindowFlag(Qt::WindowMinimizeButtonHint, true);
 	editorWindow->setWindowFlag(Qt::WindowMaximizeButtonHint, true);
 	editorWindow->setWindowModality(Qt::WindowModal);
-	connect(editorWindow, &QDialog::finished, this, [oldFileName, this]() {
-		// Open pack file
-		parser.open(oldFileName);
+	connect(editorWindow, &QDialog::finished, this, [this]() {
+		// Reload the custom pack if it was changed in the editor
+		if(customConfig && !packFromContent)
+		{
+			QSharedPointer<ConfigParser> pack = PackRegistry::pack(publicConfigName);
+			if(pack && (pack != parser))
+			{
+				parser = pack;
+				updateLessonList();
+				// The current exercise might have been removed
+				if((currentLesson > parser->lessonCount()) || (currentLevel > parser->exerciseCount(currentLesson, currentAbsoluteSublesson)))
+				{
+					currentLesson = 1;
+					currentSublesson = 1;
+					currentLevel = 1;
+				}
+				repeatLevel();
+			}
+		}
 	});
 	editorWindow->open();
 }
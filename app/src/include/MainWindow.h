@@ -30,8 +30,11 @@
 #include <QFileDialog>
 #include <QTextCursor>
 #include <QTranslator>
+#include <QProgressDialog>
+#include <QFutureWatcher>
 #include "InitialSetup.h"
 #include "widgets/InputLabelWidget.h"
+#include "widgets/TypingSurface.h"
 #include "widgets/LanguageList.h"
 #include "updater/Updater.h"
 #include "updater/UpdaterQuestion.h"
@@ -41,7 +44,13 @@
 #include "TimeDialog.h"
 #include "StatsDialog.h"
 #include "ExportDialog.h"
+#include "Mistake.h"
 #include "ConfigParser.h"
+#include "PackRegistry.h"
+#include "PackLoader.h"
+#include "BackgroundValidator.h"
+#include "TokenTable.h"
+#include "WrapLayout.h"
 #include "HistoryParser.h"
 #include "KeyboardUtils.h"
 #include "BuiltInPacks.h"
@@ -69,28 +78,35 @@ class MainWindow : public QMainWindow
 
 	private:
 		Ui::MainWindow *ui;
-		ConfigParser parser;
+		QSharedPointer<ConfigParser> parser = QSharedPointer<ConfigParser>::create();
+		bool packFromContent = false;
+		PackLoader packLoader;
+		BackgroundValidator validator;
 		void loadAddonParts(void);
 		QFrame *getTopBarFrame(AddonApi::TopBarSection section, AddonApi::TopBarPos pos);
 		QString loadConfig(QString configName, QByteArray packContent = "");
 		void startLevel(int lesson, int sublesson, int level);
 		void updateLessonList(void);
+		void appendLessons(int lastLesson);
 		void loadLesson(int lessonID, int sublessonID);
 		void loadSublesson(int levelID);
 		void levelFinalInit(void);
 		void updateText(void);
-		QString level, displayLevel, finalDisplayLevel, input, displayInput, publicConfigName, oldConfigName;
+		void updateInputSurface(const QString text, const QString errorText, const QString underlineText);
+		QString level, displayLevel, input, displayInput, publicConfigName, oldConfigName;
+		TokenTable levelTokens;
 		int lessonCount, sublessonCount, levelCount, currentLesson, currentSublesson, currentAbsoluteSublesson, currentLevel, currentLine, levelPos, displayPos, levelMistakes, totalHits, netHits, levelLengthExtension;
 		int lineCount, linePos, absolutePos;
+		WrapLayout levelLayout, timedLevelLayout;
 		int deadKeys;
 		QVector<QPair<QString, int>> recordedCharacters;
-		QList<QVariantMap> recordedMistakes;
+		MistakeList recordedMistakes;
 		int sublessonListStart;
 		QElapsedTimer levelTimer;
 		QTimer *secLoop, timedExTimer;
 		bool levelInProgress, mistake, ignoreMistakeLabelAppend;
-		QString inputLabelHtml, mistakeLabelHtml;
-		QString inputTextHtml, mistakeTextHtml;
+		QString inputLabelHtml, mistakeLabelText, mistakeText, errorAppend;
+		QVector<TypingSurface::Line> resultLines;
 		int lastTime;
 		double lastTimeF;
 		ThemeEngine localThemeEngine;
@@ -107,6 +123,8 @@ class MainWindow : public QMainWindow
 		bool blockInput;
 		void loadText(QByteArray text, bool includeNewLines = false);
 		void endExercise(bool showNetHits, bool showGrossHits, bool showTotalHits, bool showTime, bool showMistakes);
+		void applyValidationResult(const BackgroundValidator::Result &result);
+		void finishExercise(bool showNetHits, bool showGrossHits, bool showTotalHits, bool showTime, bool showMistakes);
 		QStringList errorWords;
 		void loadErrorWords(void);
 		void loadReversedText(void);
@@ -128,6 +146,7 @@ class MainWindow : public QMainWindow
 		void keyRelease(QKeyEvent *event);
 		void openOptions(void);
 		void openPack(void);
+		void addLessons(int first, int last);
 		void repeatLevel(void);
 		void nextLevel(void);
 		void previousLevel(void);
@@ -29,6 +29,7 @@
 #include "options/OptionsWindow.h"
 #include "StringUtils.h"
 #include "ThemeEngine.h"
+#include "Settings.h"
 
 namespace Ui {
 	class AppearanceOptions;
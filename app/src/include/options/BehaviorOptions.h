@@ -26,6 +26,7 @@
 #include <QCryptographicHash>
 #include <QMessageBox>
 #include "StringUtils.h"
+#include "Settings.h"
 
 namespace Ui {
 	class BehaviorOptions;
@@ -27,6 +27,7 @@
 #include "options/OptionsWindow.h"
 #include "StringUtils.h"
 #include "BuiltInPacks.h"
+#include "Settings.h"
 
 namespace Ui {
 	class KeyboardOptions;
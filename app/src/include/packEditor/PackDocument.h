@@ -0,0 +1,152 @@
+/*
+ * PackDocument.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKDOCUMENT_H
+#define PACKDOCUMENT_H
+
+#include <QObject>
+#include <QMap>
+#include <QList>
+#include "ConfigParser.h"
+
+/*!
+ * \brief The PackDocument class is the pack model used by PackEditor.
+ *
+ * The pack is parsed once (see load()) into a tree of lessons, sublessons and exercises.
+ * The tree consists of implicitly shared Qt containers, so copying it is cheap and
+ * a change copies only the nodes on the path to the changed exercise.\n
+ * A copy of the tree is stored before every change, which is used by undo() and redo().
+ * Consecutive text changes of the same exercise share one copy and only the last maxUndoSteps changes are kept.
+ *
+ * Every change is reported by a signal (for example exerciseInserted()), so that the view can be updated incrementally.
+ * The signals are emitted in reverse order with the opposite meaning when a change is undone.
+ *
+ * The pack is written by save().
+ */
+class PackDocument : public QObject
+{
+		Q_OBJECT
+	public:
+		struct Exercise
+		{
+				bool repeat = false;
+				QString repeatType = "0";
+				int repeatLimit = ConfigParser::defaultRepeatLimit;
+				int lineLength = ConfigParser::defaultLineLength;
+				QString rawText;
+		};
+
+		static const int maxUndoSteps = 100;
+
+		explicit PackDocument(QObject *parent = nullptr);
+		void load(const QByteArray content);
+		QByteArray save(void);
+		int lessonCount(void);
+		int sublessonCount(int lesson);
+		int exerciseCount(int lesson, int sublesson);
+		bool contains(int lesson, int sublesson, int exercise);
+		QString lessonDesc(int lesson);
+		Exercise exercise(int lesson, int sublesson, int exercise);
+		void addExercise(int lesson, int sublesson, int exercise, const Exercise data);
+		void updateExercise(int lesson, int sublesson, int exercise, const Exercise data);
+		void removeExercise(int lesson, int sublesson, int exercise);
+		void setLessonDesc(int lesson, const QString desc);
+		bool canUndo(void);
+		bool canRedo(void);
+
+	public slots:
+		void undo(void);
+		void redo(void);
+
+	private:
+		struct Lesson
+		{
+				QString desc;
+				QMap<int, QMap<int, Exercise>> sublessons;
+		};
+
+		enum ChangeType
+		{
+			Change_LessonInserted,
+			Change_LessonRemoved,
+			Change_LessonDesc,
+			Change_SublessonInserted,
+			Change_SublessonRemoved,
+			Change_ExerciseInserted,
+			Change_ExerciseRemoved,
+			Change_Exercise
+		};
+
+		struct Change
+		{
+				ChangeType type;
+				int lesson;
+				int sublesson;
+				int exercise;
+		};
+
+		struct Snapshot
+		{
+				QMap<int, Lesson> lessons;
+				QList<Change> changes;
+				bool textEdit = false;
+		};
+
+		QMap<int, Lesson> lessons;
+		QList<QByteArray> unparsedLines;
+		QList<Snapshot> undoStack;
+		QList<Snapshot> redoStack;
+		void beginChange(void);
+		void addChange(ChangeType type, int lesson, int sublesson = 0, int exercise = 0);
+		void endChange(void);
+		void emitChange(const Change &change, bool inverse);
+
+	signals:
+		/*! A signal, which is emitted when a new pack is loaded. */
+		void reset(void);
+		/*! A signal, which is emitted after every change (including undo and redo). */
+		void changed(void);
+		/*! A signal, which is emitted when a lesson is added. */
+		void lessonInserted(int lesson);
+		/*! A signal, which is emitted when a lesson is removed. */
+		void lessonRemoved(int lesson);
+		/*! A signal, which is emitted when a lesson description changes. */
+		void lessonDescChanged(int lesson);
+		/*! A signal, which is emitted when a sublesson is added. */
+		void sublessonInserted(int lesson, int sublesson);
+		/*! A signal, which is emitted when a sublesson is removed. */
+		void sublessonRemoved(int lesson, int sublesson);
+		/*!
+		 * A signal, which is emitted when an exercise with a new ID is added. Other exercises keep their IDs.\n
+		 * It's also emitted when removeExercise() is undone, the following exercises are moved back in that case.
+		 */
+		void exerciseInserted(int lesson, int sublesson, int exercise);
+		/*!
+		 * A signal, which is emitted when an exercise is removed. The following exercises are moved by one (see removeExercise()).\n
+		 * It's also emitted when adding an exercise is undone, other exercises keep their IDs in that case.
+		 */
+		void exerciseRemoved(int lesson, int sublesson, int exercise);
+		/*! A signal, which is emitted when an exercise changes. */
+		void exerciseChanged(int lesson, int sublesson, int exercise);
+		/*! A signal, which is emitted when undo() or redo() becomes (un)available. */
+		void undoRedoChanged(bool canUndo, bool canRedo);
+};
+
+#endif // PACKDOCUMENT_H
@@ -25,8 +25,10 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include "packEditor/PackSelector.h"
+#include "packEditor/PackDocument.h"
 #include "ConfigParser.h"
 #include "Settings.h"
+#include "PackRegistry.h"
 
 namespace Ui {
 	class PackEditor;
@@ -65,15 +67,22 @@ class PackEditor : public QDialog
 
 	private:
 		Ui::PackEditor *ui;
-		ConfigParser parser;
+		PackDocument document;
 		QString saveFileName;
 		void openPrebuilt(void);
 		void openFile(void);
-		void refreshUi(bool newLesson, bool newSublesson, bool newExercise);
+		QString lessonName(int lesson);
+		void loadLessonList(void);
+		void loadSublessonList(void);
+		void loadExerciseList(void);
+		void loadExercise(void);
+		void selectExercise(int lesson, int sublesson, int exercise);
+		bool isSelected(int lesson, int sublesson, int exercise = 0);
+		PackDocument::Exercise currentExercise(void);
+		void setCurrentExercise(const PackDocument::Exercise exercise);
+		PackDocument::Exercise newExercise(void);
 		void updateTitle(void);
 		bool newFile, readOnly, saved;
-		void deleteExerciseLine(int lesson, int sublesson, int level);
-		void changeExercisePos(QString lessonDesc, int lesson, int sublesson, int level, int nlesson, int nsublesson, int nlevel);
 		bool skipBoxUpdates, skipTextUpdates, skipTextRefresh;
 
 	protected:
@@ -101,6 +110,12 @@ class PackEditor : public QDialog
 		void changeRepeating(int index);
 		void changeRepeatLength(int limitExt);
 		void changeLineLength(int lengthExt);
+		void refreshLessonList(void);
+		void refreshLessonItem(int lesson);
+		void refreshSublessonList(int lesson);
+		void insertExerciseItem(int lesson, int sublesson);
+		void removeExerciseItem(int lesson, int sublesson);
+		void refreshExercise(int lesson, int sublesson, int exercise);
 };
 
 #endif // PACKEDITOR_H
@@ -24,13 +24,13 @@
 #include <QWidget>
 #include <QMainWindow>
 #include <QInputMethodEvent>
-#include "widgets/TextView.h"
+#include "widgets/TypingSurface.h"
 #include "KeyboardUtils.h"
 
 /*!
- * \brief The InputLabelWidget class is a TextView, which handles all key presses.
+ * \brief The InputLabelWidget class is a TypingSurface, which handles all key presses.
  *
- * The main window (OpenTyper) uses it to display the input text and receive key presses.
+ * The main window (OpenTyper) uses it to display the input text with mistakes and receive key presses.
  * \image html InputLabelWidget.png
  *
  * Usage example:
@@ -41,6 +41,7 @@
  * 	private:
  * 		explicit myClass(QWidget *parent = nullptr);
  * 		InputLabelWidget *inputText;
+ * 		QString typedText;
  *
  * 	private slots:
  * 		void keyPressed(QKeyEvent* event);
@@ -54,11 +55,12 @@
  *
  * void myClass::keyPressed(QKeyEvent* event)
  * {
- * 	inputText->setText(inputText->text() + event->text());
+ * 	typedText += event->text();
+ * 	inputText->setText(typedText);
  * }
  * \endcode
  */
-class InputLabelWidget : public TextView
+class InputLabelWidget : public TypingSurface
 {
 		Q_OBJECT
 	public:
@@ -67,6 +69,8 @@ class InputLabelWidget : public TextView
 		QWidget *parentWidget;
 
 	protected:
+		bool event(QEvent *event);
+		QVariant inputMethodQuery(Qt::InputMethodQuery query) const;
 		void inputMethodEvent(QInputMethodEvent *event);
 		void keyPressEvent(QKeyEvent *event);
 		void keyReleaseEvent(QKeyEvent *event);
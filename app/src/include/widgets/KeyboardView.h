@@ -0,0 +1,81 @@
+/*
+ * KeyboardView.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYBOARDVIEW_H
+#define KEYBOARDVIEW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QCache>
+#include <QPixmap>
+
+/*!
+ * \brief The KeyboardView class paints the keys of KeyboardWidget.
+ *
+ * Keys are stored in a flat array and all of them are painted in paintEvent().
+ * Each key has a width and a row, rows are placed below each other and keys in a row are placed from left to right.\n
+ * Keys without highlight are painted to a background pixmap, which is cached for each pair of colors (see setColors()),
+ * so switching the theme back and highlighting a key doesn't paint all the keys again.
+ */
+class KeyboardView : public QWidget
+{
+	public:
+		explicit KeyboardView(QWidget *parent = nullptr);
+		int addKey(int row, QString label, int minimumWidth, QColor fingerColor);
+		int keyCount(void);
+		void setKeyLabel(int index, QString label);
+		QString keyLabel(int index);
+		void setKeyHighlighted(int index, bool highlighted);
+		void setColors(QColor color, QColor borderColor);
+		QSize sizeHint(void) const;
+		static const int keySpacing = 3;
+		static const int keyPadding = 2;
+
+	protected:
+		void paintEvent(QPaintEvent *event);
+		void changeEvent(QEvent *event);
+
+	private:
+		struct Key
+		{
+				int row;
+				int minimumWidth;
+				QString label;
+				QColor fingerColor;
+				QColor color;
+				QColor highlightColor;
+				QRect rect;
+				bool highlighted = false;
+		};
+
+		QVector<Key> keys;
+		QSize keyboardSize;
+		QColor keyColor, keyBorderColor;
+		QCache<QPair<QRgb, QRgb>, QPixmap> backgroundCache;
+		void updateKeyGeometry(void);
+		void placeKey(int index, const QFontMetrics &metrics);
+		void updateKeyColors(void);
+		void updateKeyColor(Key *key);
+		void paintKey(QPainter *painter, const Key &key, QColor color);
+		QPixmap background(void);
+		static QColor blendColor(QColor color, QColor target, qreal divisor);
+};
+
+#endif // KEYBOARDVIEW_H
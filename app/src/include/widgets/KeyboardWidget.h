@@ -33,8 +33,10 @@
 #include <QTimer>
 #include <QPushButton>
 #include <QPropertyAnimation>
+#include <QHash>
 #include "StringUtils.h"
 #include "Settings.h"
+#include "widgets/KeyboardView.h"
 
 /*!
  * \brief The KeyboardWidget class provides a simple virtual keyboard widget.
@@ -72,22 +74,17 @@ class KeyboardWidget : public QFrame
 
 	private:
 		QVBoxLayout *mainLayout;
-		QFrame *keyboardFrame;
-		QVBoxLayout *keyboardLayout;
+		KeyboardView *keyboardFrame;
 		QPushButton *closeButton;
-		QMultiMap<QFrame *, int> keys;
-		QMap<QFrame *, QLabel *> keyLabels;
-		QMap<QFrame *, int> keyTypes;
-		QMap<QPair<int, int>, QFrame *> keyMap;
+		QMultiMap<int, int> keys;
+		QHash<int, int> keyIndex;
+		QMap<int, int> keyTypes;
+		QMap<QPair<int, int>, int> keyMap;
 		int currentRow, currentColumn;
-		QHBoxLayout *currentRowLayout = nullptr;
-		QMap<QFrame *, QString> keyBaseStyleSheets;
-		QMap<QFrame *, QPair<QColor, QColor>> keyColors;
-		QMap<QFrame *, QColor> keyFingerColors;
 		void addKey(QString keyLabelText = "", int keyCode = -1, int keyMinimumWidth = 50);
 		void nextRow(void);
 		void registerKey(int x, int y, QString keyLabelText, int keyCode, int shiftKeyCode);
-		QColor resetKeyColor(QFrame *targetKey);
+		void updateKeyIndex(void);
 		bool keyboardVisible;
 
 	protected:
@@ -25,6 +25,7 @@
 #include <QListWidget>
 #include "StringUtils.h"
 #include "LanguageManager.h"
+#include "Settings.h"
 
 /*!
  * \brief The LanguageList class is a QListWidget, which provides a language selector.
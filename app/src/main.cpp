@@ -22,6 +22,7 @@
 #include <QSettings>
 #include "MainWindow.h"
 #include "Settings.h"
+#include "PackRegistry.h"
 #include "LanguageManager.h"
 #include "IAddon.h"
 #include "AddonApi.h"
@@ -107,6 +108,10 @@ int main(int argc, char *argv[])
 	QPixmap pixmap(":/res/images/splash.png");
 	QSplashScreen splash(pixmap);
 	splash.show();
+#ifndef Q_OS_WASM
+	// Index packs in the background
+	PackRegistry::preloadAll();
+#endif // Q_OS_WASM
 	changeSplashMessage(&splash, QObject::tr("Loading addons..."));
 	a.processEvents();
 	loadAddons();
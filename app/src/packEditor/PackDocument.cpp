@@ -0,0 +1,389 @@
+/*
+ * PackDocument.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packEditor/PackDocument.h"
+
+/*! Constructs PackDocument. */
+PackDocument::PackDocument(QObject *parent) :
+	QObject(parent) { }
+
+/*!
+ * Parses the pack and clears undo history.\n
+ * If an exercise is defined more than once, the first definition is used.
+ * Lines with invalid exercise IDs and the other definitions are kept unchanged, see save().
+ */
+void PackDocument::load(const QByteArray content)
+{
+	lessons.clear();
+	unparsedLines.clear();
+	undoStack.clear();
+	redoStack.clear();
+	const QList<QByteArray> lines = content.split('\n');
+	for(int i = 0; i < lines.count(); i++)
+	{
+		QByteArray rawLine = lines[i];
+		if(rawLine.endsWith('\r'))
+			rawLine.chop(1);
+		if(rawLine.trimmed().isEmpty())
+			continue;
+		QString line = QString::fromUtf8(rawLine);
+		ExerciseRecord record = ConfigParser::parseExerciseLine(line);
+		if((record.lesson <= 0) || (record.sublesson <= 0) || (record.exercise <= 0))
+		{
+			unparsedLines.append(rawLine);
+			continue;
+		}
+		Lesson &lesson = lessons[record.lesson];
+		if(lesson.desc == "")
+			lesson.desc = record.desc;
+		QMap<int, Exercise> &sublesson = lesson.sublessons[record.sublesson];
+		if(sublesson.contains(record.exercise))
+		{
+			unparsedLines.append(rawLine);
+			continue;
+		}
+		Exercise exercise;
+		exercise.repeat = record.repeat;
+		exercise.repeatType = record.repeatType;
+		exercise.repeatLimit = record.repeatLimit;
+		exercise.lineLength = record.lineLength;
+		exercise.rawText = ConfigParser::rawText(line, record);
+		sublesson.insert(record.exercise, exercise);
+	}
+	emit reset();
+	emit undoRedoChanged(false, false);
+}
+
+/*!
+ * Returns the pack content.\n
+ * The lesson description is stored in the first exercise of every sublesson.
+ * Lines, which weren't parsed by load(), are appended at the end.
+ */
+QByteArray PackDocument::save(void)
+{
+	QByteArray out;
+	for(auto lesson = lessons.constBegin(); lesson != lessons.constEnd(); lesson++)
+	{
+		// Escape special characters in the description
+		QString desc = "";
+		for(int i = 0; i < lesson->desc.count(); i++)
+		{
+			if((lesson->desc[i] == ',') || (lesson->desc[i] == ';') || (lesson->desc[i] == '\\'))
+				desc += "\\";
+			desc += lesson->desc[i];
+		}
+		for(auto sublesson = lesson->sublessons.constBegin(); sublesson != lesson->sublessons.constEnd(); sublesson++)
+		{
+			for(auto exercise = sublesson->constBegin(); exercise != sublesson->constEnd(); exercise++)
+			{
+				out += ConfigParser::formatExercise(lesson.key(), sublesson.key(), exercise.key(),
+					exercise->repeat, exercise->repeatType, exercise->repeatLimit, exercise->lineLength,
+					exercise == sublesson->constBegin() ? desc : QString(),
+					exercise->rawText);
+			}
+		}
+	}
+	for(int i = 0; i < unparsedLines.count(); i++)
+		out += unparsedLines[i] + '\n';
+	return out;
+}
+
+/*! Returns the ID of the last lesson. */
+int PackDocument::lessonCount(void)
+{
+	if(lessons.isEmpty())
+		return 0;
+	return lessons.lastKey();
+}
+
+/*! Returns the ID of the last sublesson in the lesson. */
+int PackDocument::sublessonCount(int lesson)
+{
+	auto target = lessons.constFind(lesson);
+	if((target == lessons.constEnd()) || target->sublessons.isEmpty())
+		return 0;
+	return target->sublessons.lastKey();
+}
+
+/*! Returns the number of exercises in the sublesson. */
+int PackDocument::exerciseCount(int lesson, int sublesson)
+{
+	auto target = lessons.constFind(lesson);
+	if(target == lessons.constEnd())
+		return 0;
+	return target->sublessons.value(sublesson).count();
+}
+
+/*! Returns true if the exercise exists. */
+bool PackDocument::contains(int lesson, int sublesson, int exercise)
+{
+	auto target = lessons.constFind(lesson);
+	if(target == lessons.constEnd())
+		return false;
+	auto targetSublesson = target->sublessons.constFind(sublesson);
+	if(targetSublesson == target->sublessons.constEnd())
+		return false;
+	return targetSublesson->contains(exercise);
+}
+
+/*! Returns the lesson description (without escape sequences). */
+QString PackDocument::lessonDesc(int lesson)
+{
+	return lessons.value(lesson).desc;
+}
+
+/*! Returns the exercise, or an exercise with default values if it doesn't exist. */
+PackDocument::Exercise PackDocument::exercise(int lesson, int sublesson, int exercise)
+{
+	auto target = lessons.constFind(lesson);
+	if(target == lessons.constEnd())
+		return Exercise();
+	return target->sublessons.value(sublesson).value(exercise);
+}
+
+/*!
+ * Adds an exercise. The lesson and sublesson are created if they don't exist.\n
+ * An existing exercise is replaced.
+ */
+void PackDocument::addExercise(int lesson, int sublesson, int exercise, const Exercise data)
+{
+	beginChange();
+	if(!lessons.contains(lesson))
+	{
+		lessons.insert(lesson, Lesson());
+		addChange(Change_LessonInserted, lesson);
+	}
+	Lesson &targetLesson = lessons[lesson];
+	if(!targetLesson.sublessons.contains(sublesson))
+	{
+		targetLesson.sublessons.insert(sublesson, QMap<int, Exercise>());
+		addChange(Change_SublessonInserted, lesson, sublesson);
+	}
+	QMap<int, Exercise> &targetSublesson = targetLesson.sublessons[sublesson];
+	bool exists = targetSublesson.contains(exercise);
+	targetSublesson.insert(exercise, data);
+	addChange(exists ? Change_Exercise : Change_ExerciseInserted, lesson, sublesson, exercise);
+	endChange();
+}
+
+/*!
+ * Replaces an existing exercise.\n
+ * Consecutive changes of the text of the same exercise are merged into one undo step.
+ */
+void PackDocument::updateExercise(int lesson, int sublesson, int exercise, const Exercise data)
+{
+	if(!contains(lesson, sublesson, exercise))
+		return;
+	Exercise &target = lessons[lesson].sublessons[sublesson][exercise];
+	bool textEdit = (data.repeat == target.repeat) && (data.repeatType == target.repeatType) && (data.repeatLimit == target.repeatLimit) && (data.lineLength == target.lineLength);
+	bool merge = false;
+	if(textEdit && redoStack.isEmpty() && !undoStack.isEmpty() && undoStack.last().textEdit)
+	{
+		const Change &lastChange = undoStack.constLast().changes.constFirst();
+		merge = (lastChange.lesson == lesson) && (lastChange.sublesson == sublesson) && (lastChange.exercise == exercise);
+	}
+	if(!merge)
+		beginChange();
+	lessons[lesson].sublessons[sublesson][exercise] = data;
+	if(!merge)
+	{
+		addChange(Change_Exercise, lesson, sublesson, exercise);
+		undoStack.last().textEdit = textEdit;
+	}
+	endChange();
+}
+
+/*!
+ * Removes an exercise and moves the following exercises by one.\n
+ * Empty sublessons and lessons are removed.
+ */
+void PackDocument::removeExercise(int lesson, int sublesson, int exercise)
+{
+	if(!contains(lesson, sublesson, exercise))
+		return;
+	beginChange();
+	Lesson &targetLesson = lessons[lesson];
+	const QMap<int, Exercise> oldExercises = targetLesson.sublessons.value(sublesson);
+	QMap<int, Exercise> exercises;
+	for(auto it = oldExercises.constBegin(); it != oldExercises.constEnd(); it++)
+	{
+		if(it.key() < exercise)
+			exercises.insert(it.key(), it.value());
+		else if(it.key() > exercise)
+			exercises.insert(it.key() - 1, it.value());
+	}
+	addChange(Change_ExerciseRemoved, lesson, sublesson, exercise);
+	if(exercises.isEmpty())
+	{
+		targetLesson.sublessons.remove(sublesson);
+		addChange(Change_SublessonRemoved, lesson, sublesson);
+		if(targetLesson.sublessons.isEmpty())
+		{
+			lessons.remove(lesson);
+			addChange(Change_LessonRemoved, lesson);
+		}
+	}
+	else
+		targetLesson.sublessons.insert(sublesson, exercises);
+	endChange();
+}
+
+/*! Changes the lesson description. desc shouldn't contain escape sequences. */
+void PackDocument::setLessonDesc(int lesson, const QString desc)
+{
+	if(!lessons.contains(lesson) || (lessons.value(lesson).desc == desc))
+		return;
+	beginChange();
+	lessons[lesson].desc = desc;
+	addChange(Change_LessonDesc, lesson);
+	endChange();
+}
+
+/*! Returns true if there's a change, which can be undone. */
+bool PackDocument::canUndo(void)
+{
+	return !undoStack.isEmpty();
+}
+
+/*! Returns true if there's an undone change. */
+bool PackDocument::canRedo(void)
+{
+	return !redoStack.isEmpty();
+}
+
+/*! Undoes the last change. */
+void PackDocument::undo(void)
+{
+	if(undoStack.isEmpty())
+		return;
+	Snapshot snapshot = undoStack.takeLast();
+	Snapshot current;
+	current.lessons = lessons;
+	current.changes = snapshot.changes;
+	redoStack.append(current);
+	lessons = snapshot.lessons;
+	for(int i = snapshot.changes.count() - 1; i >= 0; i--)
+		emitChange(snapshot.changes[i], true);
+	emit changed();
+	emit undoRedoChanged(canUndo(), canRedo());
+}
+
+/*! Redoes the last undone change. */
+void PackDocument::redo(void)
+{
+	if(redoStack.isEmpty())
+		return;
+	Snapshot snapshot = redoStack.takeLast();
+	Snapshot current;
+	current.lessons = lessons;
+	current.changes = snapshot.changes;
+	undoStack.append(current);
+	lessons = snapshot.lessons;
+	for(int i = 0; i < snapshot.changes.count(); i++)
+		emitChange(snapshot.changes[i], false);
+	emit changed();
+	emit undoRedoChanged(canUndo(), canRedo());
+}
+
+/*!
+ * Stores the current tree before a change.\n
+ * The tree isn't copied, it's shared until it's modified.
+ * The oldest change is dropped if there are more than maxUndoSteps changes.
+ */
+void PackDocument::beginChange(void)
+{
+	Snapshot snapshot;
+	snapshot.lessons = lessons;
+	undoStack.append(snapshot);
+	while(undoStack.count() > maxUndoSteps)
+		undoStack.removeFirst();
+	redoStack.clear();
+}
+
+/*! Records a part of the current change. */
+void PackDocument::addChange(ChangeType type, int lesson, int sublesson, int exercise)
+{
+	Change change;
+	change.type = type;
+	change.lesson = lesson;
+	change.sublesson = sublesson;
+	change.exercise = exercise;
+	undoStack.last().changes.append(change);
+}
+
+/*! Emits signals of the current change. */
+void PackDocument::endChange(void)
+{
+	const QList<Change> changes = undoStack.last().changes;
+	for(int i = 0; i < changes.count(); i++)
+		emitChange(changes[i], false);
+	emit changed();
+	emit undoRedoChanged(canUndo(), canRedo());
+}
+
+/*! Emits the signal of a change. If inverse is true, the signal of the opposite change is emitted. */
+void PackDocument::emitChange(const Change &change, bool inverse)
+{
+	switch(change.type)
+	{
+		case Change_LessonInserted:
+			if(inverse)
+				emit lessonRemoved(change.lesson);
+			else
+				emit lessonInserted(change.lesson);
+			break;
+		case Change_LessonRemoved:
+			if(inverse)
+				emit lessonInserted(change.lesson);
+			else
+				emit lessonRemoved(change.lesson);
+			break;
+		case Change_LessonDesc:
+			emit lessonDescChanged(change.lesson);
+			break;
+		case Change_SublessonInserted:
+			if(inverse)
+				emit sublessonRemoved(change.lesson, change.sublesson);
+			else
+				emit sublessonInserted(change.lesson, change.sublesson);
+			break;
+		case Change_SublessonRemoved:
+			if(inverse)
+				emit sublessonInserted(change.lesson, change.sublesson);
+			else
+				emit sublessonRemoved(change.lesson, change.sublesson);
+			break;
+		case Change_ExerciseInserted:
+			if(inverse)
+				emit exerciseRemoved(change.lesson, change.sublesson, change.exercise);
+			else
+				emit exerciseInserted(change.lesson, change.sublesson, change.exercise);
+			break;
+		case Change_ExerciseRemoved:
+			if(inverse)
+				emit exerciseInserted(change.lesson, change.sublesson, change.exercise);
+			else
+				emit exerciseRemoved(change.lesson, change.sublesson, change.exercise);
+			break;
+		case Change_Exercise:
+			emit exerciseChanged(change.lesson, change.sublesson, change.exercise);
+			break;
+	}
+}
@@ -43,6 +43,9 @@ PackEditor::PackEditor(QWidget *parent) :
 	}); // closeFile() will open the file because openPrebuiltPack = true
 	connect(ui->saveAction, &QAction::triggered, this, &PackEditor::save);
 	connect(ui->saveAsAction, &QAction::triggered, this, &PackEditor::saveAs);
+	// Edit menu
+	connect(ui->undoAction, &QAction::triggered, &document, &PackDocument::undo);
+	connect(ui->redoAction, &QAction::triggered, &document, &PackDocument::redo);
 	// Add buttons
 	connect(ui->newLessonButton, SIGNAL(clicked()), this, SLOT(addLesson()));
 	connect(ui->newSublessonButton, SIGNAL(clicked()), this, SLOT(addSublesson()));
@@ -62,11 +65,33 @@ PackEditor::PackEditor(QWidget *parent) :
 	// Spin boxes
 	connect(ui->repeatLengthBox, SIGNAL(valueChanged(int)), this, SLOT(changeRepeatLength(int)));
 	connect(ui->lineLengthBox, SIGNAL(valueChanged(int)), this, SLOT(changeLineLength(int)));
+	// Document
+	connect(&document, &PackDocument::reset, this, [this]() {
+		loadLessonList();
+		selectExercise(1, 1, 1);
+	});
+	connect(&document, &PackDocument::changed, this, [this]() {
+		saved = false;
+		updateTitle();
+	});
+	connect(&document, &PackDocument::undoRedoChanged, this, [this](bool canUndo, bool canRedo) {
+		ui->undoAction->setEnabled(canUndo);
+		ui->redoAction->setEnabled(canRedo);
+	});
+	connect(&document, &PackDocument::lessonInserted, this, &PackEditor::refreshLessonList);
+	connect(&document, &PackDocument::lessonRemoved, this, &PackEditor::refreshLessonList);
+	connect(&document, &PackDocument::lessonDescChanged, this, &PackEditor::refreshLessonItem);
+	connect(&document, &PackDocument::sublessonInserted, this, &PackEditor::refreshSublessonList);
+	connect(&document, &PackDocument::sublessonRemoved, this, &PackEditor::refreshSublessonList);
+	connect(&document, &PackDocument::exerciseInserted, this, &PackEditor::insertExerciseItem);
+	connect(&document, &PackDocument::exerciseRemoved, this, &PackEditor::removeExerciseItem);
+	connect(&document, &PackDocument::exerciseChanged, this, &PackEditor::refreshExercise);
 	// Default values
-	createNewFile();
+	saved = false;
 	skipBoxUpdates = false;
 	skipTextUpdates = false;
 	skipTextRefresh = false;
+	createNewFile();
 }
 
 /*! Destroys the PackEditor object. */
@@ -102,14 +127,9 @@ void PackEditor::openFile(void)
 			saveFileName = fileName;
 			newFile = false;
 			readOnly = false;
-			parser.loadToBuffer(fileContent);
-			refreshUi(false, false, false);
-			ui->lessonSelectionBox->setCurrentIndex(0);
-			refreshUi(false, false, false);
-			ui->sublessonSelectionBox->setCurrentIndex(0);
-			refreshUi(false, false, false);
-			ui->exerciseSelectionBox->setCurrentIndex(0);
+			document.load(fileContent);
 			saved = true;
+			updateTitle();
 		}
 	};
 	QFileDialog::getOpenFileContent("Open-Typer pack (*.typer)", readOpenedFile);
@@ -133,26 +153,20 @@ void PackEditor::openFile(QString path, bool newf, bool rdonly)
 	readOnly = rdonly;
 	if(newFile)
 	{
-		// Clear buffer
-		parser.loadToBuffer("");
+		// Clear the document
+		document.load("");
 		addLesson();
 	}
 	else
 	{
-		// Load existing data into buffer
+		// Load existing data into the document
 		QFile openedFile(path);
 		openedFile.open(QFile::ReadOnly | QFile::Text);
-		parser.loadToBuffer(openedFile.readAll());
+		document.load(openedFile.readAll());
 		openedFile.close();
-		refreshUi(false, false, false);
-		ui->lessonSelectionBox->setCurrentIndex(0);
-		refreshUi(false, false, false);
-		ui->sublessonSelectionBox->setCurrentIndex(0);
-		refreshUi(false, false, false);
-		ui->exerciseSelectionBox->setCurrentIndex(0);
 		saved = true;
 	}
-	refreshUi(false, false, false);
+	updateTitle();
 }
 
 /*! Closes opened file. */
@@ -192,7 +206,6 @@ void PackEditor::closeFile(bool createNew, bool open, bool openPrebuiltPack)
 				save();
 			if(notSavedBox->clickedButton() != cancelButton)
 			{
-				parser.close();
 				if(createNew)
 					createNewFile();
 				else if(open)
@@ -210,128 +223,196 @@ void PackEditor::closeFile(bool createNew, bool open, bool openPrebuiltPack)
 	}
 }
 
-/*!
- * Updates the title, loads selected exercise and refreshes widgets.
- *
- * \param[in] newLesson Whether to add a new lesson.
- * \param[in] newSublesson Whether to add a new sublesson.
- * \param[in] newExercise Whether to add a new exercise.
- *
- * \see updateTitle()
- * \see addLesson()
- * \see addSublesson()
- * \see addExercise()
- * \see ConfigParser
- */
-void PackEditor::refreshUi(bool newLesson, bool newSublesson, bool newExercise)
+/*! Returns the name of the lesson (with description) used in lessonSelectionBox. */
+QString PackEditor::lessonName(int lesson)
+{
+	QString desc = ConfigParser::parseDesc(document.lessonDesc(lesson));
+	if(desc == "")
+		return ConfigParser::lessonTr(lesson);
+	else
+		return ConfigParser::lessonTr(lesson) + " " + desc;
+}
+
+/*! Fills lessonSelectionBox. The selected index is kept if possible. */
+void PackEditor::loadLessonList(void)
 {
-	updateTitle();
-	// Lesson selector
 	int oldLesson = ui->lessonSelectionBox->currentIndex();
-	int i, count = parser.lessonCount();
-	if(newLesson)
-		count++;
 	ui->lessonSelectionBox->clear();
 	QStringList lessons;
-	QString _lessonDesc;
+	int i, count = document.lessonCount();
 	for(i = 1; i <= count; i++)
-	{
-		if(newLesson && (i == count))
-			_lessonDesc = "";
-		else
-			_lessonDesc = ConfigParser::parseDesc(parser.lessonDesc(i));
-		if(_lessonDesc == "")
-			lessons += ConfigParser::lessonTr(i);
-		else
-			lessons += ConfigParser::lessonTr(i) + " " + _lessonDesc;
-	}
+		lessons += lessonName(i);
 	ui->lessonSelectionBox->addItems(lessons);
-	if(newLesson)
-		oldLesson = ui->lessonSelectionBox->count() - 1;
-	ui->lessonSelectionBox->setCurrentIndex(oldLesson);
-	// Sublesson selector
+	ui->lessonSelectionBox->setCurrentIndex(qMax(0, qMin(oldLesson, count - 1)));
+}
+
+/*!
+ * Fills sublessonSelectionBox with sublessons of the selected lesson.\n
+ * Missing sublessons are marked as empty. The selected index is kept if possible.
+ */
+void PackEditor::loadSublessonList(void)
+{
+	int lesson = ui->lessonSelectionBox->currentIndex() + 1;
 	int oldSublesson = ui->sublessonSelectionBox->currentIndex();
-	int sublessonCount;
-	if(newLesson)
-	{
-		sublessonCount = 0;
-		newSublesson = true;
-	}
-	else
-		sublessonCount = parser.sublessonCount(oldLesson + 1);
-	if(newSublesson)
-		sublessonCount++;
 	ui->sublessonSelectionBox->clear();
 	QStringList sublessons;
-	int i2 = 0;
-	for(i = 1; i <= sublessonCount + i2; i++)
+	int i, count = document.sublessonCount(lesson);
+	for(i = 1; i <= count; i++)
 	{
-		if(parser.exerciseCount(oldLesson + 1, i) > 0)
+		if(document.exerciseCount(lesson, i) > 0)
 			sublessons += ConfigParser::sublessonName(i);
 		else
-		{
 			sublessons += " (" + tr("empty") + ")";
-			if(!((newLesson || newSublesson) && (i >= sublessonCount + i2)))
-				i2++;
-		}
 	}
 	ui->sublessonSelectionBox->addItems(sublessons);
-	if(newSublesson)
-		oldSublesson = ui->sublessonSelectionBox->count() - 1;
-	ui->sublessonSelectionBox->setCurrentIndex(oldSublesson);
-	// Exercise selector
+	ui->sublessonSelectionBox->setCurrentIndex(qMax(0, qMin(oldSublesson, count - 1)));
+}
+
+/*! Fills exerciseSelectionBox with exercises of the selected sublesson. The selected index is kept if possible. */
+void PackEditor::loadExerciseList(void)
+{
 	int oldExercise = ui->exerciseSelectionBox->currentIndex();
-	int exerciseCount = parser.exerciseCount(oldLesson + 1, oldSublesson + 1);
 	ui->exerciseSelectionBox->clear();
 	QStringList exercises;
-	for(i = 1; i <= exerciseCount; i++)
+	int i, count = document.exerciseCount(ui->lessonSelectionBox->currentIndex() + 1, ui->sublessonSelectionBox->currentIndex() + 1);
+	for(i = 1; i <= count; i++)
 		exercises += ConfigParser::exerciseTr(i);
 	ui->exerciseSelectionBox->addItems(exercises);
-	if(newExercise)
-		oldExercise = ui->exerciseSelectionBox->count() - 1;
-	ui->exerciseSelectionBox->setCurrentIndex(oldExercise);
-	if(newLesson || newSublesson)
-		addExercise();
-	else
+	ui->exerciseSelectionBox->setCurrentIndex(qMax(0, qMin(oldExercise, count - 1)));
+}
+
+/*! Loads the selected exercise and lesson options. */
+void PackEditor::loadExercise(void)
+{
+	restoreText();
+	int lesson = ui->lessonSelectionBox->currentIndex() + 1;
+	// Lesson description
+	QString lessonDesc = "";
+	QString rawLessonDesc = document.lessonDesc(lesson);
+	for(int i = 0; i < rawLessonDesc.count(); i++)
 	{
-		restoreText();
-		// Lesson description
-		QString lessonDesc = "";
-		QString rawLessonDesc = parser.lessonDesc(oldLesson + 1);
-		for(i = 0; i < rawLessonDesc.count(); i++)
+		if((rawLessonDesc[i] == '%') && (i + 1 < rawLessonDesc.count()) && (rawLessonDesc[i + 1] == 'b'))
 		{
-			if((rawLessonDesc[i] == '%') && (rawLessonDesc[i + 1] == 'b'))
-			{
-				lessonDesc += ' ';
-				i++;
-			}
-			else
-				lessonDesc += rawLessonDesc[i];
+			lessonDesc += ' ';
+			i++;
 		}
-		ui->lessonDescEdit->setText(lessonDesc);
-		// Repeat type
-		QString repeatType = parser.exerciseRepeatType(oldLesson + 1, oldSublesson + 1, oldExercise + 1);
-		if((repeatType == "w") || (repeatType == "rw")) // Don't remove "rw", it's for old packs
-			ui->repeatingBox->setCurrentIndex(1);
-		else if(repeatType == "s")
-			ui->repeatingBox->setCurrentIndex(2);
 		else
-			ui->repeatingBox->setCurrentIndex(0);
-		// Text length
-		if(ui->repeatingBox->currentIndex() != 0)
-		{
-			ui->repeatLengthBox->setEnabled(true);
-			skipBoxUpdates = true;
-			ui->repeatLengthBox->setValue(parser.exerciseRepeatLimit(oldLesson + 1, oldSublesson + 1, oldExercise + 1));
-			skipBoxUpdates = false;
-		}
-		else
-			ui->repeatLengthBox->setEnabled(false);
-		// Line length
+			lessonDesc += rawLessonDesc[i];
+	}
+	// Don't move the cursor if the description is being edited
+	if(ui->lessonDescEdit->text() != lessonDesc)
+		ui->lessonDescEdit->setText(lessonDesc);
+	PackDocument::Exercise exercise = currentExercise();
+	// Repeat type
+	QString repeatType = exercise.repeatType;
+	if((repeatType == "w") || (repeatType == "rw")) // Don't remove "rw", it's for old packs
+		ui->repeatingBox->setCurrentIndex(1);
+	else if(repeatType == "s")
+		ui->repeatingBox->setCurrentIndex(2);
+	else
+		ui->repeatingBox->setCurrentIndex(0);
+	// Text length
+	if(ui->repeatingBox->currentIndex() != 0)
+	{
+		ui->repeatLengthBox->setEnabled(true);
 		skipBoxUpdates = true;
-		ui->lineLengthBox->setValue(parser.exerciseLineLength(oldLesson + 1, oldSublesson + 1, oldExercise + 1));
+		ui->repeatLengthBox->setValue(exercise.repeatLimit);
 		skipBoxUpdates = false;
 	}
+	else
+		ui->repeatLengthBox->setEnabled(false);
+	// Line length
+	skipBoxUpdates = true;
+	ui->lineLengthBox->setValue(exercise.lineLength);
+	skipBoxUpdates = false;
+}
+
+/*! Selects an exercise and loads it. */
+void PackEditor::selectExercise(int lesson, int sublesson, int exercise)
+{
+	ui->lessonSelectionBox->setCurrentIndex(lesson - 1);
+	loadSublessonList();
+	ui->sublessonSelectionBox->setCurrentIndex(sublesson - 1);
+	loadExerciseList();
+	ui->exerciseSelectionBox->setCurrentIndex(exercise - 1);
+	loadExercise();
+}
+
+/*! Returns true if the exercise is selected. If exercise is 0, only the lesson and sublesson are checked. */
+bool PackEditor::isSelected(int lesson, int sublesson, int exercise)
+{
+	return (lesson == ui->lessonSelectionBox->currentIndex() + 1) && (sublesson == ui->sublessonSelectionBox->currentIndex() + 1) && ((exercise == 0) || (exercise == ui->exerciseSelectionBox->currentIndex() + 1));
+}
+
+/*! Returns the selected exercise. */
+PackDocument::Exercise PackEditor::currentExercise(void)
+{
+	return document.exercise(ui->lessonSelectionBox->currentIndex() + 1,
+		ui->sublessonSelectionBox->currentIndex() + 1,
+		ui->exerciseSelectionBox->currentIndex() + 1);
+}
+
+/*! Replaces the selected exercise. */
+void PackEditor::setCurrentExercise(const PackDocument::Exercise exercise)
+{
+	document.updateExercise(ui->lessonSelectionBox->currentIndex() + 1,
+		ui->sublessonSelectionBox->currentIndex() + 1,
+		ui->exerciseSelectionBox->currentIndex() + 1,
+		exercise);
+}
+
+/*! Connected from PackDocument#lessonInserted() and PackDocument#lessonRemoved(). */
+void PackEditor::refreshLessonList(void)
+{
+	loadLessonList();
+	loadSublessonList();
+	loadExerciseList();
+	loadExercise();
+}
+
+/*! Connected from PackDocument#lessonDescChanged(). */
+void PackEditor::refreshLessonItem(int lesson)
+{
+	if(lesson <= ui->lessonSelectionBox->count())
+		ui->lessonSelectionBox->setItemText(lesson - 1, lessonName(lesson));
+	if(lesson == ui->lessonSelectionBox->currentIndex() + 1)
+		loadExercise();
+}
+
+/*! Connected from PackDocument#sublessonInserted() and PackDocument#sublessonRemoved(). */
+void PackEditor::refreshSublessonList(int lesson)
+{
+	if(lesson != ui->lessonSelectionBox->currentIndex() + 1)
+		return;
+	loadSublessonList();
+	loadExerciseList();
+	loadExercise();
+}
+
+/*! Connected from PackDocument#exerciseInserted(). */
+void PackEditor::insertExerciseItem(int lesson, int sublesson)
+{
+	if(!isSelected(lesson, sublesson))
+		return;
+	// Exercise IDs in a sublesson are consecutive, so the new item is always the last one
+	ui->exerciseSelectionBox->addItem(ConfigParser::exerciseTr(ui->exerciseSelectionBox->count() + 1));
+	loadExercise();
+}
+
+/*! Connected from PackDocument#exerciseRemoved(). */
+void PackEditor::removeExerciseItem(int lesson, int sublesson)
+{
+	if(!isSelected(lesson, sublesson))
+		return;
+	ui->exerciseSelectionBox->removeItem(ui->exerciseSelectionBox->count() - 1);
+	loadExercise();
+}
+
+/*! Connected from PackDocument#exerciseChanged(). */
+void PackEditor::refreshExercise(int lesson, int sublesson, int exercise)
+{
+	if(isSelected(lesson, sublesson, exercise))
+		loadExercise();
 }
 
 /*! Updates the title. */
@@ -343,6 +424,18 @@ void PackEditor::updateTitle(void)
 	ui->title->setText(saved ? _saveFileName : _saveFileName + "*");
 }
 
+/*! Returns a new exercise with default values. */
+PackDocument::Exercise PackEditor::newExercise(void)
+{
+	PackDocument::Exercise exercise;
+	exercise.repeat = false;
+	exercise.repeatType = "0";
+	exercise.repeatLimit = 120;
+	exercise.lineLength = 60;
+	exercise.rawText = tr("New exercise");
+	return exercise;
+}
+
 /*!
  * Connected from newLessonButton->clicked().\n
  * Adds a new lesson.
@@ -352,7 +445,9 @@ void PackEditor::updateTitle(void)
  */
 void PackEditor::addLesson(void)
 {
-	refreshUi(true, false, false);
+	int lesson = document.lessonCount() + 1;
+	document.addExercise(lesson, 1, 1, newExercise());
+	selectExercise(lesson, 1, 1);
 }
 
 /*!
@@ -366,7 +461,10 @@ void PackEditor::addSublesson(void)
 {
 	if(ui->lessonSelectionBox->count() == 0)
 		return;
-	refreshUi(false, true, false);
+	int lesson = ui->lessonSelectionBox->currentIndex() + 1;
+	int sublesson = document.sublessonCount(lesson) + 1;
+	document.addExercise(lesson, sublesson, 1, newExercise());
+	selectExercise(lesson, sublesson, 1);
 }
 
 /*!
@@ -380,74 +478,22 @@ void PackEditor::addExercise(void)
 {
 	if(ui->sublessonSelectionBox->count() == 0)
 		return;
-	parser.addExercise(ui->lessonSelectionBox->currentIndex() + 1,
-		ui->sublessonSelectionBox->currentIndex() + 1,
-		ui->exerciseSelectionBox->count() + 1,
-		false, "0", 120, 60, "",
-		tr("New exercise"));
-	saved = false;
-	refreshUi(false, false, true);
+	int lesson = ui->lessonSelectionBox->currentIndex() + 1;
+	int sublesson = ui->sublessonSelectionBox->currentIndex() + 1;
+	int exercise = document.exerciseCount(lesson, sublesson) + 1;
+	document.addExercise(lesson, sublesson, exercise, newExercise());
+	selectExercise(lesson, sublesson, exercise);
 }
 
 /*!
  * Connected from removeExerciseButton->clicked().\n
- * Removes selected exercise.
+ * Removes selected exercise. Following exercises are moved by one.
  */
 void PackEditor::removeExercise(void)
 {
-	int i, targetLesson, targetSublesson, targetLevel;
-	targetLesson = ui->lessonSelectionBox->currentIndex() + 1;
-	targetSublesson = ui->sublessonSelectionBox->currentIndex() + 1;
-	targetLevel = ui->exerciseSelectionBox->currentIndex() + 1;
-	int oldCount = parser.exerciseCount(targetLesson, targetSublesson);
-	// Delete line
-	QString lessonDesc = parser.lessonDesc(targetLesson);
-	deleteExerciseLine(targetLesson, targetSublesson, targetLevel);
-	// Fix empty space
-	for(i = targetLevel; i <= oldCount - 1; i++)
-		changeExercisePos(lessonDesc, targetLesson, targetSublesson, i + 1, targetLesson, targetSublesson, i);
-	if(targetLevel == oldCount)
-		ui->exerciseSelectionBox->setCurrentIndex(oldCount - 2);
-	refreshUi(false, false, false);
-}
-
-/*! Moves exercise to a new position (lesson, sublesson, exercise). */
-void PackEditor::changeExercisePos(QString lessonDesc, int lesson, int sublesson, int level, int nlesson, int nsublesson, int nlevel)
-{
-	int limitExt, lengthExt;
-	limitExt = parser.exerciseRepeatLimit(lesson, sublesson, level);
-	lengthExt = parser.exerciseLineLength(lesson, sublesson, level);
-	QString repeatType = parser.exerciseRepeatType(lesson, sublesson, level);
-	if(nlevel != 1)
-		lessonDesc = "";
-	QString targetText = parser.exerciseRawText(lesson, sublesson, level);
-	deleteExerciseLine(lesson, sublesson, level);
-	bool repeat;
-	repeat = (repeatType != "0");
-	parser.addExercise(nlesson, nsublesson, nlevel, repeat, repeatType, limitExt, lengthExt, lessonDesc, targetText);
-	saved = false;
-}
-
-/*! Removes an exercise from the temporary file. */
-void PackEditor::deleteExerciseLine(int lesson, int sublesson, int level)
-{
-	int targetLine, curLine;
-	targetLine = parser.exerciseLine(lesson, sublesson, level);
-	QBuffer buffer;
-	buffer.open(QBuffer::ReadWrite);
-	buffer.write(parser.data());
-	QByteArray out;
-	buffer.seek(0);
-	curLine = 0;
-	while(!buffer.atEnd())
-	{
-		curLine++;
-		QByteArray line = buffer.readLine();
-		if(curLine != targetLine)
-			out += line;
-	}
-	buffer.close();
-	parser.loadToBuffer(out);
+	document.removeExercise(ui->lessonSelectionBox->currentIndex() + 1,
+		ui->sublessonSelectionBox->currentIndex() + 1,
+		ui->exerciseSelectionBox->currentIndex() + 1);
 }
 
 /*!
@@ -459,29 +505,12 @@ void PackEditor::changeLessonDesc(const QString rawLessonDesc)
 	QString lessonDesc = "";
 	for(int i = 0; i < rawLessonDesc.count(); i++)
 	{
-		if((rawLessonDesc[i] == ',') || (rawLessonDesc[i] == ';') || (rawLessonDesc[i] == '\\'))
-			lessonDesc += "\\";
 		if(rawLessonDesc[i] == ' ')
 			lessonDesc += "%b";
 		else
 			lessonDesc += rawLessonDesc[i];
 	}
-	int sublessonCount = parser.sublessonCount(ui->lessonSelectionBox->currentIndex() + 1);
-	int i, i2 = 0;
-	for(i = 1; i <= sublessonCount + i2; i++)
-	{
-		int levelCount = parser.exerciseCount(ui->lessonSelectionBox->currentIndex() + 1, i);
-		if(levelCount > 0)
-		{
-			changeExercisePos(
-				lessonDesc,
-				ui->lessonSelectionBox->currentIndex() + 1, i, 1,
-				ui->lessonSelectionBox->currentIndex() + 1, i, 1);
-		}
-		else
-			i2++;
-	}
-	refreshUi(false, false, false);
+	document.setLessonDesc(ui->lessonSelectionBox->currentIndex() + 1, lessonDesc);
 }
 
 /*!
@@ -502,19 +531,7 @@ void PackEditor::updateText(void)
 {
 	if(skipTextUpdates)
 		return;
-	int lesson, sublesson, level, limitExt, lengthExt;
-	lesson = ui->lessonSelectionBox->currentIndex() + 1;
-	sublesson = ui->sublessonSelectionBox->currentIndex() + 1;
-	level = ui->exerciseSelectionBox->currentIndex() + 1;
-	limitExt = parser.exerciseRepeatLimit(lesson, sublesson, level);
-	lengthExt = parser.exerciseLineLength(lesson, sublesson, level);
-	QString repeatType = parser.exerciseRepeatType(lesson, sublesson, level);
-	QString lessonDesc;
-	if((sublesson == 1) && (level == 1))
-		lessonDesc = parser.lessonDesc(lesson);
-	else
-		lessonDesc = "";
-	deleteExerciseLine(lesson, sublesson, level);
+	PackDocument::Exercise exercise = currentExercise();
 	QString sourceText = ui->levelTextEdit->toPlainText();
 	QString targetText = "";
 	for(int i = 0; i < sourceText.count(); i++)
@@ -524,29 +541,21 @@ void PackEditor::updateText(void)
 		else
 			targetText += sourceText[i];
 	}
-	bool repeat;
-	repeat = (repeatType != "0");
-	parser.addExercise(lesson, sublesson, level, repeat, repeatType, limitExt, lengthExt, lessonDesc, targetText);
-	saved = false;
+	exercise.rawText = targetText;
+	exercise.repeat = (exercise.repeatType != "0");
 	skipTextRefresh = true;
-	restoreText();
+	setCurrentExercise(exercise);
 	skipTextRefresh = false;
-	updateTitle();
 }
 
 /*! Loads current exercise text. */
 void PackEditor::restoreText(void)
 {
+	PackDocument::Exercise exercise = currentExercise();
 	ui->levelLabel->setText(
 		ConfigParser::initExercise(
-			parser.exerciseText(
-				ui->lessonSelectionBox->currentIndex() + 1,
-				ui->sublessonSelectionBox->currentIndex() + 1,
-				ui->exerciseSelectionBox->currentIndex() + 1),
-			parser.exerciseLineLength(
-				ui->lessonSelectionBox->currentIndex() + 1,
-				ui->sublessonSelectionBox->currentIndex() + 1,
-				ui->exerciseSelectionBox->currentIndex() + 1)));
+			ConfigParser::generateText(exercise.rawText, exercise.repeat, exercise.repeatType, exercise.repeatLimit),
+			exercise.lineLength));
 	QString textLengthStr = tr("Text length:") + " ";
 	if(skipTextRefresh)
 	{
@@ -554,10 +563,7 @@ void PackEditor::restoreText(void)
 		return;
 	}
 	skipTextUpdates = true;
-	ui->levelTextEdit->setPlainText(parser.exerciseRawText(
-		ui->lessonSelectionBox->currentIndex() + 1,
-		ui->sublessonSelectionBox->currentIndex() + 1,
-		ui->exerciseSelectionBox->currentIndex() + 1));
+	ui->levelTextEdit->setPlainText(exercise.rawText);
 	skipTextUpdates = false;
 	ui->textLengthLabel->setText(textLengthStr + QString::number(ui->levelTextEdit->toPlainText().count()));
 }
@@ -571,12 +577,7 @@ void PackEditor::restoreText(void)
  */
 void PackEditor::switchLesson(void)
 {
-	for(int i = 0; i < 2; i++)
-	{
-		ui->sublessonSelectionBox->setCurrentIndex(0);
-		ui->exerciseSelectionBox->setCurrentIndex(0);
-		refreshUi(false, false, false);
-	}
+	selectExercise(ui->lessonSelectionBox->currentIndex() + 1, 1, 1);
 }
 
 /*!
@@ -588,11 +589,7 @@ void PackEditor::switchLesson(void)
  */
 void PackEditor::switchSublesson(void)
 {
-	for(int i = 0; i < 2; i++)
-	{
-		ui->exerciseSelectionBox->setCurrentIndex(0);
-		refreshUi(false, false, false);
-	}
+	selectExercise(ui->lessonSelectionBox->currentIndex() + 1, ui->sublessonSelectionBox->currentIndex() + 1, 1);
 }
 
 /*!
@@ -604,7 +601,7 @@ void PackEditor::switchSublesson(void)
  */
 void PackEditor::switchExercise(void)
 {
-	refreshUi(false, false, false);
+	loadExercise();
 }
 
 /*!
@@ -613,36 +610,20 @@ void PackEditor::switchExercise(void)
  */
 void PackEditor::changeRepeating(int index)
 {
-	int lesson, sublesson, level, limitExt, lengthExt;
-	lesson = ui->lessonSelectionBox->currentIndex() + 1;
-	sublesson = ui->sublessonSelectionBox->currentIndex() + 1;
-	level = ui->exerciseSelectionBox->currentIndex() + 1;
-	limitExt = parser.exerciseRepeatLimit(lesson, sublesson, level);
-	lengthExt = parser.exerciseLineLength(lesson, sublesson, level);
-	QString repeatType;
+	PackDocument::Exercise exercise = currentExercise();
 	switch(index)
 	{
 		case 1:
 			// Words
-			repeatType = "w";
+			exercise.repeatType = "w";
 			break;
 		default:
 			// None
-			repeatType = "0";
+			exercise.repeatType = "0";
 			break;
 	}
-	QString lessonDesc;
-	if((sublesson == 1) && (level == 1))
-		lessonDesc = parser.lessonDesc(lesson);
-	else
-		lessonDesc = "";
-	QString targetText = parser.exerciseRawText(lesson, sublesson, level);
-	deleteExerciseLine(lesson, sublesson, level);
-	bool repeat;
-	repeat = (repeatType != "0");
-	parser.addExercise(lesson, sublesson, level, repeat, repeatType, limitExt, lengthExt, lessonDesc, targetText);
-	saved = false;
-	refreshUi(false, false, false);
+	exercise.repeat = (exercise.repeatType != "0");
+	setCurrentExercise(exercise);
 }
 
 /*!
@@ -653,24 +634,10 @@ void PackEditor::changeRepeatLength(int limitExt)
 {
 	if(skipBoxUpdates)
 		return;
-	int lesson, sublesson, level, lengthExt;
-	lesson = ui->lessonSelectionBox->currentIndex() + 1;
-	sublesson = ui->sublessonSelectionBox->currentIndex() + 1;
-	level = ui->exerciseSelectionBox->currentIndex() + 1;
-	lengthExt = parser.exerciseLineLength(lesson, sublesson, level);
-	QString repeatType = parser.exerciseRepeatType(lesson, sublesson, level);
-	QString lessonDesc;
-	if((sublesson == 1) && (level == 1))
-		lessonDesc = parser.lessonDesc(lesson);
-	else
-		lessonDesc = "";
-	QString targetText = parser.exerciseRawText(lesson, sublesson, level);
-	deleteExerciseLine(lesson, sublesson, level);
-	bool repeat;
-	repeat = (repeatType != "0");
-	parser.addExercise(lesson, sublesson, level, repeat, repeatType, limitExt, lengthExt, lessonDesc, targetText);
-	saved = false;
-	refreshUi(false, false, false);
+	PackDocument::Exercise exercise = currentExercise();
+	exercise.repeatLimit = limitExt;
+	exercise.repeat = (exercise.repeatType != "0");
+	setCurrentExercise(exercise);
 }
 
 /*!
@@ -681,24 +648,10 @@ void PackEditor::changeLineLength(int lengthExt)
 {
 	if(skipBoxUpdates)
 		return;
-	int lesson, sublesson, level, limitExt;
-	lesson = ui->lessonSelectionBox->currentIndex() + 1;
-	sublesson = ui->sublessonSelectionBox->currentIndex() + 1;
-	level = ui->exerciseSelectionBox->currentIndex() + 1;
-	limitExt = parser.exerciseRepeatLimit(lesson, sublesson, level);
-	QString repeatType = parser.exerciseRepeatType(lesson, sublesson, level);
-	QString lessonDesc;
-	if((sublesson == 1) && (level == 1))
-		lessonDesc = parser.lessonDesc(lesson);
-	else
-		lessonDesc = "";
-	QString targetText = parser.exerciseRawText(lesson, sublesson, level);
-	deleteExerciseLine(lesson, sublesson, level);
-	bool repeat;
-	repeat = (repeatType == "0");
-	parser.addExercise(lesson, sublesson, level, repeat, repeatType, limitExt, lengthExt, lessonDesc, targetText);
-	saved = false;
-	refreshUi(false, false, false);
+	PackDocument::Exercise exercise = currentExercise();
+	exercise.lineLength = lengthExt;
+	exercise.repeat = (exercise.repeatType == "0");
+	setCurrentExercise(exercise);
 }
 
 /*!
@@ -714,9 +667,12 @@ void PackEditor::save(void)
 		QFile saveQFile(saveFileName);
 		if(saveQFile.open(QFile::WriteOnly | QFile::Text))
 		{
-			saveQFile.write(parser.data());
+			saveQFile.write(document.save());
+			saveQFile.close();
+			// The file ID of PackRegistry might not change (see PackRegistry#fileId())
+			PackRegistry::remove(saveFileName);
 			saved = true;
-			refreshUi(false, false, false);
+			updateTitle();
 		}
 		else
 			readOnly = true;
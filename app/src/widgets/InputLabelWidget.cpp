@@ -22,16 +22,38 @@
 
 /*! Constructs InputLabelWidget. */
 InputLabelWidget::InputLabelWidget(QWidget *parent) :
-	TextView(parent)
+	TypingSurface(parent)
 {
 	parentWidget = parent;
 	setAttribute(Qt::WA_InputMethodEnabled, true);
-	setHorizontalAdjust(false);
 }
 
 /*! Destroys the InputLabelWidget object. */
 InputLabelWidget::~InputLabelWidget() { }
 
+/*! Overrides QWidget#event() so that tab doesn't move focus to another widget. */
+bool InputLabelWidget::event(QEvent *event)
+{
+	if(event->type() == QEvent::KeyPress)
+	{
+		QKeyEvent *keyEvent = static_cast<QKeyEvent *>(event);
+		if((keyEvent->key() == Qt::Key_Tab) || (keyEvent->key() == Qt::Key_Backtab))
+		{
+			keyPressEvent(keyEvent);
+			return true;
+		}
+	}
+	return TypingSurface::event(event);
+}
+
+/*! Overrides QWidget#inputMethodQuery() so that input method popups are shown at the cursor. */
+QVariant InputLabelWidget::inputMethodQuery(Qt::InputMethodQuery query) const
+{
+	if(query == Qt::ImCursorRectangle)
+		return cursorRect();
+	return TypingSurface::inputMethodQuery(query);
+}
+
 /*!
  * Overrides QWidget#inputMethodEvent.
  * Handles characters composed using dead keys.
@@ -0,0 +1,238 @@
+/*
+ * KeyboardView.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QPainter>
+#include <QPaintEvent>
+#include "widgets/KeyboardView.h"
+
+/*! Constructs KeyboardView. */
+KeyboardView::KeyboardView(QWidget *parent) :
+	QWidget(parent),
+	backgroundCache(8)
+{
+	setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+	setColors(palette().color(QPalette::Button), palette().color(QPalette::Mid));
+}
+
+/*!
+ * Adds a key to the end of the row and returns its index.\n
+ * The key is wider than minimumWidth if the label doesn't fit.
+ * If fingerColor isn't black, the key color is slightly tinted with it (see setColors()).
+ */
+int KeyboardView::addKey(int row, QString label, int minimumWidth, QColor fingerColor)
+{
+	Key key;
+	key.row = row;
+	key.minimumWidth = minimumWidth;
+	key.label = label;
+	key.fingerColor = fingerColor;
+	updateKeyColor(&key);
+	keys.append(key);
+	placeKey(keys.count() - 1, fontMetrics());
+	QRect rect = keys.last().rect;
+	keyboardSize = keyboardSize.expandedTo(QSize(rect.right() + 1, rect.bottom() + 1));
+	backgroundCache.clear();
+	updateGeometry();
+	update();
+	return keys.count() - 1;
+}
+
+/*! Returns the number of keys. */
+int KeyboardView::keyCount(void)
+{
+	return keys.count();
+}
+
+/*! Sets the label of a key. */
+void KeyboardView::setKeyLabel(int index, QString label)
+{
+	if(keys[index].label == label)
+		return;
+	QRect oldRect = keys[index].rect;
+	keys[index].label = label;
+	placeKey(index, fontMetrics());
+	if(keys[index].rect == oldRect)
+	{
+		backgroundCache.clear();
+		update(oldRect);
+	}
+	else
+		updateKeyGeometry();
+}
+
+/*! Returns the label of a key. */
+QString KeyboardView::keyLabel(int index)
+{
+	return keys[index].label;
+}
+
+/*! Highlights or dehighlights a key. Only the area of the key is painted again. */
+void KeyboardView::setKeyHighlighted(int index, bool highlighted)
+{
+	if(keys[index].highlighted == highlighted)
+		return;
+	keys[index].highlighted = highlighted;
+	update(keys[index].rect);
+}
+
+/*!
+ * Sets the background and border color of the keys.\n
+ * Background pixmaps of the last used colors are kept, so switching back to a previous theme doesn't paint the keys again.
+ */
+void KeyboardView::setColors(QColor color, QColor borderColor)
+{
+	keyColor = color;
+	keyBorderColor = borderColor;
+	updateKeyColors();
+	update();
+}
+
+/*! Overrides QWidget#sizeHint(). */
+QSize KeyboardView::sizeHint(void) const
+{
+	return keyboardSize;
+}
+
+/*! Overrides QWidget#paintEvent(). */
+void KeyboardView::paintEvent(QPaintEvent *event)
+{
+	QPainter painter(this);
+	painter.drawPixmap(0, 0, background());
+	painter.setRenderHint(QPainter::Antialiasing);
+	for(int i = 0; i < keys.count(); i++)
+	{
+		if(keys[i].highlighted && event->rect().intersects(keys[i].rect))
+			paintKey(&painter, keys[i], keys[i].highlightColor);
+	}
+}
+
+/*! Overrides QWidget#changeEvent(). */
+void KeyboardView::changeEvent(QEvent *event)
+{
+	switch(event->type())
+	{
+		case QEvent::FontChange:
+			updateKeyGeometry();
+			break;
+		case QEvent::PaletteChange:
+		case QEvent::StyleChange:
+			// The label color may have changed
+			backgroundCache.clear();
+			update();
+			break;
+		default:
+			break;
+	}
+	QWidget::changeEvent(event);
+}
+
+/*! Calculates the position and size of all keys. */
+void KeyboardView::updateKeyGeometry(void)
+{
+	QFontMetrics metrics = fontMetrics();
+	keyboardSize = QSize(0, 0);
+	for(int i = 0; i < keys.count(); i++)
+	{
+		placeKey(i, metrics);
+		keyboardSize = keyboardSize.expandedTo(QSize(keys[i].rect.right() + 1, keys[i].rect.bottom() + 1));
+	}
+	backgroundCache.clear();
+	updateGeometry();
+	update();
+}
+
+/*! Calculates the position and size of a key. Keys before it must already be placed. */
+void KeyboardView::placeKey(int index, const QFontMetrics &metrics)
+{
+	Key &key = keys[index];
+	int keyHeight = metrics.height() * 2 + keyPadding * 2;
+	int x = 0;
+	if((index > 0) && (keys[index - 1].row == key.row))
+		x = keys[index - 1].rect.right() + 1 + keySpacing;
+	int labelWidth = 0;
+	const QStringList lines = key.label.split('\n');
+	for(int i = 0; i < lines.count(); i++)
+	{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+		labelWidth = qMax(labelWidth, metrics.horizontalAdvance(lines[i]));
+#else
+		labelWidth = qMax(labelWidth, metrics.width(lines[i]));
+#endif
+	}
+	key.rect = QRect(x, key.row * (keyHeight + keySpacing), qMax(key.minimumWidth, labelWidth + keyPadding * 2), keyHeight);
+}
+
+/*! Calculates the background and highlight color of all keys. */
+void KeyboardView::updateKeyColors(void)
+{
+	for(int i = 0; i < keys.count(); i++)
+		updateKeyColor(&keys[i]);
+}
+
+/*! Calculates the background and highlight color of a key. */
+void KeyboardView::updateKeyColor(KeyboardView::Key *key)
+{
+	QColor fingerColor = key->fingerColor;
+	key->color = keyColor;
+	if(!((fingerColor.red() == 0) && (fingerColor.green() == 0) && (fingerColor.blue() == 0)))
+		key->color = blendColor(keyColor, fingerColor, 7.5);
+	key->highlightColor = blendColor(QColor(0, 175, 255), key->color, 1.2);
+}
+
+/*! Paints a key with the given background color. */
+void KeyboardView::paintKey(QPainter *painter, const KeyboardView::Key &key, QColor color)
+{
+	painter->setPen(keyBorderColor);
+	painter->setBrush(color);
+	painter->drawRoundedRect(QRectF(key.rect).adjusted(0.5, 0.5, -0.5, -0.5), 5, 5);
+	painter->setPen(palette().color(QPalette::WindowText));
+	painter->drawText(key.rect.adjusted(keyPadding, keyPadding, -keyPadding, -keyPadding), Qt::AlignLeft | Qt::AlignTop, key.label);
+}
+
+/*! Returns the keys without highlight painted for the current colors. */
+QPixmap KeyboardView::background(void)
+{
+	if(keyboardSize.isEmpty())
+		return QPixmap();
+	QPair<QRgb, QRgb> cacheKey(keyColor.rgba(), keyBorderColor.rgba());
+	qreal pixelRatio = devicePixelRatioF();
+	QPixmap *cached = backgroundCache.object(cacheKey);
+	if(cached && (cached->devicePixelRatioF() == pixelRatio))
+		return *cached;
+	QPixmap *pixmap = new QPixmap(keyboardSize * pixelRatio);
+	pixmap->setDevicePixelRatio(pixelRatio);
+	pixmap->fill(Qt::transparent);
+	QPainter painter(pixmap);
+	painter.setRenderHint(QPainter::Antialiasing);
+	painter.setFont(font());
+	for(int i = 0; i < keys.count(); i++)
+		paintKey(&painter, keys[i], keys[i].color);
+	painter.end();
+	backgroundCache.insert(cacheKey, pixmap);
+	return *pixmap;
+}
+
+/*! Returns color moved towards target by 1/divisor of the difference. */
+QColor KeyboardView::blendColor(QColor color, QColor target, qreal divisor)
+{
+	return QColor::fromRgb(color.red() + (target.red() - color.red()) / divisor,
+		color.green() + (target.green() - color.green()) / divisor,
+		color.blue() + (target.blue() - color.blue()) / divisor);
+}
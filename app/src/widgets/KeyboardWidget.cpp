@@ -24,27 +24,19 @@
 KeyboardWidget::KeyboardWidget(QWidget *parent) :
 	QFrame(parent),
 	mainLayout(new QVBoxLayout(this)),
-	keyboardFrame(new QFrame(this)),
-	keyboardLayout(new QVBoxLayout(keyboardFrame)),
+	keyboardFrame(new KeyboardView(this)),
 	currentRow(-1),
 	currentColumn(0),
 	keyboardVisible(true)
 {
 	mainLayout->setSizeConstraint(QLayout::SetFixedSize);
 	mainLayout->setSpacing(0);
-	keyboardLayout->setSpacing(3);
 	mainLayout->setContentsMargins(0, 0, 0, 0);
-	keyboardLayout->setContentsMargins(0, 0, 0, 0);
-	keyboardFrame->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
 	mainLayout->addWidget(keyboardFrame);
 	keyboardFrame->installEventFilter(this);
 	keys.clear();
-	keyLabels.clear();
 	keyMap.clear();
 	keyTypes.clear();
-	keyBaseStyleSheets.clear();
-	keyColors.clear();
-	keyFingerColors.clear();
 	// Close button
 	closeButton = new QPushButton(this);
 	setKeyboardVisible(Settings::keyboardVisible());
@@ -82,6 +74,7 @@ KeyboardWidget::KeyboardWidget(QWidget *parent) :
 	addKey("", Qt::Key_Space, 475);
 	addKey("Alt", Qt::Key_AltGr, 75);
 	addKey("Ctrl", -3, 103); // Qt doesn't recognize left and right control; -3 is a special code for right control
+	updateKeyIndex();
 	// Connections
 	connect(closeButton, &QPushButton::clicked, this, &KeyboardWidget::toggleKeyboard);
 }
@@ -89,16 +82,10 @@ KeyboardWidget::KeyboardWidget(QWidget *parent) :
 /*! Adds a key. */
 void KeyboardWidget::addKey(QString keyLabelText, int keyCode, int keyMinimumWidth)
 {
-	if(currentRowLayout == nullptr)
+	if(currentRow < 0)
 		return;
 	if(!keyLabelText.contains("\n"))
 		keyLabelText += "\n";
-	// Create key frame
-	QFrame *newKey = new QFrame(this);
-	newKey->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-	newKey->setMinimumWidth(keyMinimumWidth);
-	newKey->setFrameShape(QFrame::WinPanel);
-	newKey->setFrameStyle(QFrame::WinPanel | QFrame::Raised);
 	Finger finger = keyFinger(currentColumn, currentRow);
 	QColor keyColor(0, 0, 0);
 	switch(finger)
@@ -122,21 +109,9 @@ void KeyboardWidget::addKey(QString keyLabelText, int keyCode, int keyMinimumWid
 		default:
 			break;
 	}
-	keyBaseStyleSheets.insert(newKey, "QFrame { border-radius: 5px; }");
-	keyFingerColors.insert(newKey, keyColor);
-	newKey->setStyleSheet(keyBaseStyleSheets[newKey]);
-	currentRowLayout->addWidget(newKey);
+	int newKey = keyboardFrame->addKey(currentRow, keyLabelText, keyMinimumWidth, keyColor);
 	keyMap.insert(QPair<int, int>(currentColumn, currentRow), newKey);
 	currentColumn++;
-	// Create key label
-	QHBoxLayout *keyLayout = new QHBoxLayout(newKey);
-	QLabel *keyLabel = new QLabel(keyLabelText, newKey);
-	keyLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
-	keyLabel->setAlignment(Qt::AlignLeft | Qt::AlignTop);
-	keyLabel->setMargin(0);
-	keyLayout->addWidget(keyLabel);
-	keyLayout->setContentsMargins(1, 1, 1, 1);
-	keyLabels.insert(newKey, keyLabel);
 	// Save the key
 	keys.insert(newKey, keyCode);
 	keyTypes.insert(newKey, 0);
@@ -145,16 +120,6 @@ void KeyboardWidget::addKey(QString keyLabelText, int keyCode, int keyMinimumWid
 /*! Starts a new row. */
 void KeyboardWidget::nextRow(void)
 {
-	QFrame *currentRowFrame = new QFrame(this);
-	currentRowFrame->setContentsMargins(0, 0, 0, 0);
-	currentRowFrame->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
-	currentRowFrame->setFrameShape(QFrame::NoFrame);
-	currentRowFrame->setFrameStyle(QFrame::NoFrame | QFrame::Plain);
-	currentRowLayout = new QHBoxLayout(currentRowFrame);
-	currentRowLayout->setSizeConstraint(QLayout::SetFixedSize);
-	currentRowLayout->setSpacing(3);
-	currentRowLayout->setContentsMargins(0, 0, 0, 0);
-	keyboardLayout->addWidget(currentRowFrame);
 	currentRow++;
 	currentColumn = 0;
 }
@@ -167,53 +132,18 @@ void KeyboardWidget::registerKey(int x, int y, QString keyLabelText, int keyCode
 		return;
 	if(!keyLabelText.contains("\n"))
 		keyLabelText += "\n";
-	QFrame *targetKeyFrame = keyMap[keyPos];
-	keys.remove(targetKeyFrame);
-	keys.insert(targetKeyFrame, keyCode);
-	keys.insert(targetKeyFrame, shiftKeyCode);
-	keyLabels[targetKeyFrame]->setText(keyLabelText);
-	keyTypes[targetKeyFrame] = 1;
+	int targetKey = keyMap[keyPos];
+	keys.remove(targetKey);
+	keys.insert(targetKey, keyCode);
+	keys.insert(targetKey, shiftKeyCode);
+	keyboardFrame->setKeyLabel(targetKey, keyLabelText);
+	keyTypes[targetKey] = 1;
 }
 
-/*! Sets color of all keys. */
+/*! Sets color of all keys. Keys used by fingers are tinted with the finger color. */
 void KeyboardWidget::setKeyColor(QColor color, QColor borderColor)
 {
-	QList<QFrame *> keyList = keys.keys();
-	for(int i = 0; i < keyList.count(); i++)
-	{
-		QColor fingerColor = keyFingerColors[keyList[i]];
-		QColor newColor = color;
-		if(!((fingerColor.red() == 0) && (fingerColor.green() == 0) && (fingerColor.blue() == 0)))
-		{
-			newColor = QColor::fromRgb(color.red() + (fingerColor.red() - color.red()) / 7.5,
-				color.green() + (fingerColor.green() - color.green()) / 7.5,
-				color.blue() + (fingerColor.blue() - color.blue()) / 7.5);
-		}
-		keyList[i]->setStyleSheet(keyBaseStyleSheets[keyList[i]]);
-		keyList[i]->setStyleSheet(keyBaseStyleSheets[keyList[i]] + "QFrame { background-color: rgb(" + QString::number(newColor.red()) + ", " + QString::number(newColor.green()) + ", " + QString::number(newColor.blue()) + "); border: 1px solid rgb(" + QString::number(borderColor.red()) + ", " + QString::number(borderColor.green()) + ", " + QString::number(borderColor.blue()) + "); }" + "QLabel { border: 0px; }");
-		keyColors[keyList[i]] = QPair<QColor, QColor>(color, borderColor);
-	}
-}
-
-/*! Resets color of a key and returns new color. */
-QColor KeyboardWidget::resetKeyColor(QFrame *targetKey)
-{
-	if(keyColors.contains(targetKey))
-	{
-		QColor color = keyColors[targetKey].first;
-		QColor borderColor = keyColors[targetKey].second;
-		QColor fingerColor = keyFingerColors[targetKey];
-		if(!((fingerColor.red() == 0) && (fingerColor.green() == 0) && (fingerColor.blue() == 0)))
-		{
-			color = QColor::fromRgb(color.red() + (fingerColor.red() - color.red()) / 7.5,
-				color.green() + (fingerColor.green() - color.green()) / 7.5,
-				color.blue() + (fingerColor.blue() - color.blue()) / 7.5);
-		}
-		targetKey->setStyleSheet(keyBaseStyleSheets[targetKey]);
-		targetKey->setStyleSheet(keyBaseStyleSheets[targetKey] + "QFrame { background-color: rgb(" + QString::number(color.red()) + ", " + QString::number(color.green()) + ", " + QString::number(color.blue()) + "); border: 1px solid rgb(" + QString::number(borderColor.red()) + ", " + QString::number(borderColor.green()) + ", " + QString::number(borderColor.blue()) + "); }" + "QLabel { border: 0px; }");
-		return color;
-	}
-	return QColor();
+	keyboardFrame->setColors(color, borderColor);
 }
 
 /*! Loads a keyboard layout. */
@@ -254,36 +184,41 @@ bool KeyboardWidget::loadLayout(QLocale::Language language, QLocale::Country cou
 			}
 			registerKey(layoutKey["x"].toInt(), layoutKey["y"].toInt(), layoutKey["label"].toString(), keyCode, shiftKeyCode);
 		}
+		updateKeyIndex();
 		return true;
 	}
 	return false;
 }
 
-/*! Highlights a key. */
-void KeyboardWidget::highlightKey(int keyCode)
+/*!
+ * Updates the index of keys by key code, which is used by highlightKey() and dehighlightKey().\n
+ * If more keys have the same key code, the key with the lowest index is used.
+ */
+void KeyboardWidget::updateKeyIndex(void)
 {
-	QList<int> keyCodes = keys.values();
-	if(keyCodes.contains(keyCode))
+	keyIndex.clear();
+	keyIndex.reserve(keys.count());
+	for(auto it = keys.constBegin(); it != keys.constEnd(); it++)
 	{
-		QFrame *targetKey = keys.key(keyCode);
-		QColor oldColor = resetKeyColor(targetKey);
-		QColor keyBgColor = QColor(0, 175, 255);
-		keyBgColor = QColor::fromRgb(keyBgColor.red() + (oldColor.red() - keyBgColor.red()) / 1.2,
-			keyBgColor.green() + (oldColor.green() - keyBgColor.green()) / 1.2,
-			keyBgColor.blue() + (oldColor.blue() - keyBgColor.blue()) / 1.2);
-		targetKey->setStyleSheet(keyBaseStyleSheets[targetKey] + "QFrame { background-color: rgb(" + QString::number(keyBgColor.red()) + ", " + QString::number(keyBgColor.green()) + ", " + QString::number(keyBgColor.blue()) + "); }");
+		if(!keyIndex.contains(it.value()))
+			keyIndex.insert(it.value(), it.key());
 	}
 }
 
+/*! Highlights a key. */
+void KeyboardWidget::highlightKey(int keyCode)
+{
+	int targetKey = keyIndex.value(keyCode, -1);
+	if(targetKey != -1)
+		keyboardFrame->setKeyHighlighted(targetKey, true);
+}
+
 /*! Dehighlights a key. */
 void KeyboardWidget::dehighlightKey(int keyCode)
 {
-	QList<int> keyCodes = keys.values();
-	if(keyCodes.contains(keyCode))
-	{
-		QFrame *targetKey = keys.key(keyCode);
-		resetKeyColor(targetKey);
-	}
+	int targetKey = keyIndex.value(keyCode, -1);
+	if(targetKey != -1)
+		keyboardFrame->setKeyHighlighted(targetKey, false);
 }
 
 /*! Returns the finger that should be used to press the key. */
@@ -507,13 +442,11 @@ KeyboardWidget::Finger KeyboardWidget::keyFinger(int keyX, int keyY)
 /*! Finds a key that contains label and returns its position. */
 QPoint KeyboardWidget::findKey(QString label)
 {
-	QList<QLabel *> labels = keyLabels.values();
-	for(int i = 0; i < labels.count(); i++)
+	for(int i = 0; i < keyboardFrame->keyCount(); i++)
 	{
-		if((labels[i]->text().contains(label, Qt::CaseInsensitive)) && (keyTypes[keyLabels.key(labels[i])] == 1))
+		if((keyboardFrame->keyLabel(i).contains(label, Qt::CaseInsensitive)) && (keyTypes[i] == 1))
 		{
-			QFrame *targetKey = keyLabels.key(labels[i]);
-			QPair<int, int> keyPos = keyMap.key(targetKey);
+			QPair<int, int> keyPos = keyMap.key(i);
 			return QPoint(keyPos.first, keyPos.second);
 		}
 	}
@@ -0,0 +1,19 @@
+QT += core concurrent
+QT -= gui
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = open-typer-grade
+DESTDIR = $$_PRO_FILE_PWD_/..
+
+INCLUDEPATH += src/include ../libcore/src/include
+
+LIBS += -L$$_PRO_FILE_PWD_/.. -lopentyper-core
+
+SOURCES += \
+    src/Grader.cpp \
+    src/main.cpp
+
+HEADERS += \
+    src/include/Grader.h
@@ -0,0 +1,217 @@
+/*
+ * Grader.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <QFile>
+#include <QDir>
+#include <QSettings>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "Grader.h"
+#include "StringUtils.h"
+#include "FileUtils.h"
+#include "ValidationSettings.h"
+
+/*! Constructs Grader. */
+Grader::Grader(const QString exerciseText, const Rules rules) :
+	m_exerciseText(exerciseText),
+	m_rules(rules)
+{
+	// The app adds a new line to the text of timed exercises
+	if(m_rules.timed)
+		m_exerciseText += '\n';
+}
+
+/*! Grades the submission. This can be used in any thread. */
+Grader::Grade Grader::operator()(const Submission &submission) const
+{
+	Grade grade;
+	grade.id = submission.id;
+	grade.characters = submission.input.count();
+	grade.error = submission.error;
+	if(!grade.error.isEmpty())
+		return grade;
+	StringUtils::validateExercise(m_exerciseText, submission.input, submission.recordedCharacters, &grade.grossHits, &grade.mistakes, &grade.errorWords, m_rules.timed, m_rules.timeSecs, m_rules.mistakeChars, &grade.bandWidth);
+	grade.netHits = std::max(0, grade.grossHits - grade.mistakes * m_rules.errorPenalty);
+	return grade;
+}
+
+/*! Returns the rules set in the app. Settings aren't used, so that QApplication isn't needed. */
+Grader::Rules Grader::loadRules(void)
+{
+	QSettings settings(FileUtils::mainSettingsLocation(), QSettings::IniFormat);
+	Rules rules;
+	rules.errorPenalty = ValidationSettings::errorPenalty(settings);
+	rules.mistakeChars = ValidationSettings::mistakeChars(settings);
+	return rules;
+}
+
+/*! Reads a UTF-8 text file. The new line at the end of the file is removed. */
+QString Grader::readText(const QString fileName, bool *ok)
+{
+	QFile file(fileName);
+	*ok = file.open(QIODevice::ReadOnly | QIODevice::Text);
+	if(!(*ok))
+		return QString();
+	QString out = QString::fromUtf8(file.readAll());
+	if(out.endsWith('\n'))
+		out.chop(1);
+	return out;
+}
+
+/*! Reads a submission from each file in the directory. Submissions are sorted by file name. \see readText() */
+QList<Grader::Submission> Grader::readDirectory(const QString path)
+{
+	QList<Submission> out;
+	QDir dir(path);
+	const QStringList fileNames = dir.entryList(QDir::Files, QDir::Name);
+	for(int i = 0; i < fileNames.count(); i++)
+	{
+		Submission submission;
+		submission.id = fileNames[i];
+		bool ok;
+		submission.input = readText(dir.filePath(fileNames[i]), &ok);
+		if(ok)
+			submission.recordedCharacters = estimateCharacters(submission.input);
+		else
+			submission.error = "Failed to read the file";
+		out += submission;
+	}
+	return out;
+}
+
+/*!
+ * Reads submissions from a JSONL file. Each line contains an object with these keys:
+ *  - \c id - Submission ID (optional, the line number is used by default).
+ *  - \c input - The input text.
+ *  - \c recordedCharacters - List of [text, hits] pairs for each typed character (optional, see estimateCharacters()).
+ *
+ * Invalid lines are returned as submissions with an error.
+ */
+QList<Grader::Submission> Grader::readJsonl(const QString fileName, bool *ok)
+{
+	QList<Submission> out;
+	QFile file(fileName);
+	*ok = file.open(QIODevice::ReadOnly | QIODevice::Text);
+	if(!(*ok))
+		return out;
+	int lineNumber = 0;
+	while(!file.atEnd())
+	{
+		QByteArray line = file.readLine().trimmed();
+		lineNumber++;
+		if(line.isEmpty())
+			continue;
+		Submission submission;
+		submission.id = QString::number(lineNumber);
+		QJsonParseError parseError;
+		QJsonDocument document = QJsonDocument::fromJson(line, &parseError);
+		if(!document.isObject())
+		{
+			submission.error = parseError.error == QJsonParseError::NoError ? "The record isn't an object" : parseError.errorString();
+			out += submission;
+			continue;
+		}
+		QJsonObject record = document.object();
+		if(record.contains("id"))
+			submission.id = record.value("id").toVariant().toString();
+		submission.input = record.value("input").toString();
+		if(record.contains("recordedCharacters"))
+		{
+			const QJsonArray characters = record.value("recordedCharacters").toArray();
+			for(int i = 0; i < characters.count(); i++)
+			{
+				const QJsonArray character = characters[i].toArray();
+				submission.recordedCharacters += QPair<QString, int>(character.at(0).toString(), character.at(1).toInt());
+			}
+		}
+		else
+			submission.recordedCharacters = estimateCharacters(submission.input);
+		out += submission;
+	}
+	return out;
+}
+
+/*!
+ * Returns recorded characters for an input text without recorded key presses.\n
+ * Each character is 1 hit, upper case letters are 2 hits (with the shift key).
+ */
+QVector<QPair<QString, int>> Grader::estimateCharacters(const QString input)
+{
+	QVector<QPair<QString, int>> out;
+	out.reserve(input.count());
+	for(int i = 0; i < input.count(); i++)
+		out += QPair<QString, int>(QString(input[i]), input[i].isUpper() ? 2 : 1);
+	return out;
+}
+
+/*! Returns the grade as a JSON line. */
+QByteArray Grader::toJson(const Grade &grade)
+{
+	QJsonObject object;
+	object["id"] = grade.id;
+	if(grade.error.isEmpty())
+	{
+		object["grossHits"] = grade.grossHits;
+		object["netHits"] = grade.netHits;
+		object["mistakes"] = grade.mistakes;
+		object["bandWidth"] = grade.bandWidth;
+		object["errorWords"] = QJsonArray::fromStringList(grade.errorWords);
+	}
+	else
+		object["error"] = grade.error;
+	return QJsonDocument(object).toJson(QJsonDocument::Compact) + "\n";
+}
+
+/*! Returns the header line of the CSV output. \see toCsv() */
+QByteArray Grader::csvHeader(void)
+{
+	return "id,grossHits,netHits,mistakes,bandWidth,errorWords,error\n";
+}
+
+/*! Returns the grade as a CSV line. Error words are separated by spaces. */
+QByteArray Grader::toCsv(const Grade &grade)
+{
+	QStringList fields;
+	fields += csvField(grade.id);
+	if(grade.error.isEmpty())
+	{
+		fields += QString::number(grade.grossHits);
+		fields += QString::number(grade.netHits);
+		fields += QString::number(grade.mistakes);
+		fields += QString::number(grade.bandWidth);
+		fields += csvField(grade.errorWords.join(' '));
+		fields += "";
+	}
+	else
+		fields << "" << "" << "" << "" << "" << csvField(grade.error);
+	return fields.join(',').toUtf8() + "\n";
+}
+
+/*! Quotes the CSV field if needed. */
+QString Grader::csvField(const QString value)
+{
+	if(!value.contains(',') && !value.contains('"') && !value.contains('\n') && !value.contains('\r'))
+		return value;
+	QString out = value;
+	out.replace("\"", "\"\"");
+	return "\"" + out + "\"";
+}
@@ -0,0 +1,94 @@
+/*
+ * Grader.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GRADER_H
+#define GRADER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+#include <QList>
+
+/*!
+ * \brief The Grader class grades typed submissions of an exercise.
+ *
+ * Submissions are validated by StringUtils#validateExercise(), so the results are the same as in the app.\n
+ * Grader is a function object, so it can be used with QtConcurrent::mapped().
+ * The band width used to align timed submissions (see StringUtils#alignPrefix()) is included in the grade.
+ *
+ * Example usage:
+ * \code
+ * Grader grader("Some text", Grader::loadRules());
+ * QList<Grader::Submission> submissions = Grader::readDirectory("submissions");
+ * QFuture<Grader::Grade> future = QtConcurrent::mapped(submissions, grader);
+ * printf("%d\n", future.resultAt(0).netHits);
+ * \endcode
+ */
+class Grader
+{
+	public:
+		struct Rules
+		{
+				bool timed = false;
+				int timeSecs = 0;
+				int errorPenalty = 0;
+				int mistakeChars = 0;
+		};
+
+		struct Submission
+		{
+				QString id;
+				QString input;
+				QVector<QPair<QString, int>> recordedCharacters;
+				QString error;
+		};
+
+		struct Grade
+		{
+				QString id;
+				int characters = 0;
+				int grossHits = 0;
+				int netHits = 0;
+				int mistakes = 0;
+				int bandWidth = 0;
+				QStringList errorWords;
+				QString error;
+		};
+
+		typedef Grade result_type;
+		Grader(const QString exerciseText, const Rules rules);
+		Grade operator()(const Submission &submission) const;
+		static Rules loadRules(void);
+		static QString readText(const QString fileName, bool *ok);
+		static QList<Submission> readDirectory(const QString path);
+		static QList<Submission> readJsonl(const QString fileName, bool *ok);
+		static QVector<QPair<QString, int>> estimateCharacters(const QString input);
+		static QByteArray toJson(const Grade &grade);
+		static QByteArray csvHeader(void);
+		static QByteArray toCsv(const Grade &grade);
+
+	private:
+		QString m_exerciseText;
+		Rules m_rules;
+		static QString csvField(const QString value);
+};
+
+#endif // GRADER_H
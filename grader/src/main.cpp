@@ -0,0 +1,148 @@
+/*
+ * main.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include "Grader.h"
+
+/*!
+ * Grades typed submissions of an exercise using the rules set in the app.\n
+ * Results are written in the order of the submissions (as JSON lines or CSV) and a throughput report is written to stderr.\n
+ * Usage: open-typer-grade [options] <exercise> <submissions>
+ *
+ * Returns 4 if some submissions couldn't be graded.
+ * \see Grader
+ */
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	QCoreApplication::setOrganizationDomain("open-typer.sourceforge.io");
+	QCoreApplication::setOrganizationName("Open-Typer");
+	QCoreApplication::setApplicationName("Open-Typer");
+	QTextStream err(stderr);
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Grades typed submissions of an exercise.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("exercise", "Text file with the exercise text.");
+	parser.addPositionalArgument("submissions", "Directory with a text file for each submission, or a JSONL file.");
+	QCommandLineOption formatOption("format", "Output format: jsonl (default) or csv.", "format", "jsonl");
+	QCommandLineOption outputOption(QStringList({ "o", "output" }), "Write the results to <file> instead of stdout.", "file");
+	QCommandLineOption timeOption("time", "Grade a timed exercise with the time limit in seconds.", "seconds");
+	QCommandLineOption errorPenaltyOption("error-penalty", "Number of hits subtracted from net hits on every mistake.", "hits");
+	QCommandLineOption mistakeCharsOption("mistake-chars", "Max. one mistake per <chars> characters in a word (0 means no limit).", "chars");
+	QCommandLineOption threadsOption("threads", "Number of worker threads.", "count");
+	parser.addOption(formatOption);
+	parser.addOption(outputOption);
+	parser.addOption(timeOption);
+	parser.addOption(errorPenaltyOption);
+	parser.addOption(mistakeCharsOption);
+	parser.addOption(threadsOption);
+	parser.process(a);
+	const QStringList args = parser.positionalArguments();
+	QString format = parser.value(formatOption);
+	if((args.count() != 2) || ((format != "jsonl") && (format != "csv")))
+		parser.showHelp(1);
+	// Rules
+	Grader::Rules rules = Grader::loadRules();
+	bool ok = true;
+	if(parser.isSet(timeOption))
+	{
+		rules.timed = true;
+		rules.timeSecs = parser.value(timeOption).toInt(&ok);
+	}
+	if(ok && parser.isSet(errorPenaltyOption))
+		rules.errorPenalty = parser.value(errorPenaltyOption).toInt(&ok);
+	if(ok && parser.isSet(mistakeCharsOption))
+		rules.mistakeChars = parser.value(mistakeCharsOption).toInt(&ok);
+	if(ok && parser.isSet(threadsOption))
+	{
+		int threads = parser.value(threadsOption).toInt(&ok);
+		if(ok && (threads > 0))
+			QThreadPool::globalInstance()->setMaxThreadCount(threads);
+	}
+	if(!ok)
+		parser.showHelp(1);
+	// Input
+	QString exerciseText = Grader::readText(args[0], &ok);
+	if(!ok)
+	{
+		err << "Failed to open " << args[0] << "\n";
+		return 2;
+	}
+	QList<Grader::Submission> submissions;
+	if(QFileInfo(args[1]).isDir())
+		submissions = Grader::readDirectory(args[1]);
+	else
+	{
+		submissions = Grader::readJsonl(args[1], &ok);
+		if(!ok)
+		{
+			err << "Failed to open " << args[1] << "\n";
+			return 2;
+		}
+	}
+	// Output
+	QFile outFile;
+	if(parser.isSet(outputOption))
+	{
+		outFile.setFileName(parser.value(outputOption));
+		ok = outFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+	}
+	else
+		ok = outFile.open(stdout, QIODevice::WriteOnly);
+	if(!ok)
+	{
+		err << "Failed to write " << parser.value(outputOption) << "\n";
+		return 3;
+	}
+	bool csv = (format == "csv");
+	if(csv)
+		outFile.write(Grader::csvHeader());
+	// Grade in the thread pool and write the results in the order of the submissions as soon as they're ready
+	QElapsedTimer timer;
+	timer.start();
+	QFuture<Grader::Grade> future = QtConcurrent::mapped(submissions, Grader(exerciseText, rules));
+	qint64 characters = 0;
+	int failed = 0;
+	for(int i = 0; i < submissions.count(); i++)
+	{
+		Grader::Grade grade = future.resultAt(i);
+		characters += grade.characters;
+		if(!grade.error.isEmpty())
+			failed++;
+		outFile.write(csv ? Grader::toCsv(grade) : Grader::toJson(grade));
+		outFile.flush();
+	}
+	double seconds = timer.nsecsElapsed() / 1000000000.0;
+	err << QString("Graded %1 submissions (%2 failed, %3 characters) in %4 s using %5 threads: %6 submissions/s, %7 characters/s\n")
+			   .arg(submissions.count())
+			   .arg(failed)
+			   .arg(characters)
+			   .arg(seconds, 0, 'f', 3)
+			   .arg(QThreadPool::globalInstance()->maxThreadCount())
+			   .arg(seconds > 0 ? submissions.count() / seconds : 0, 0, 'f', 1)
+			   .arg(seconds > 0 ? characters / seconds : 0, 0, 'f', 0);
+	return failed > 0 ? 4 : 0;
+}
@@ -1,4 +1,4 @@
-QT += widgets network websockets charts
+QT += widgets network websockets charts concurrent
 
 !wasm {
 	QT += sql printsupport
@@ -16,7 +16,9 @@ INCLUDEPATH += src/include
 
 SOURCES += \
     src/AddonApi.cpp \
+    src/BackgroundValidator.cpp \
     src/BuiltInPacks.cpp \
+    src/CompiledPack.cpp \
     src/ConfigParser.cpp \
     src/ExportDialog.cpp \
     src/FileUtils.cpp \
@@ -24,16 +26,25 @@ SOURCES += \
     src/KeyboardUtils.cpp \
     src/LanguageManager.cpp \
     src/LoadExerciseDialog.cpp \
+    src/Mistake.cpp \
+    src/PackLoader.cpp \
+    src/PackRegistry.cpp \
     src/Settings.cpp \
     src/StatsDialog.cpp \
     src/StringUtils.cpp \
     src/widgets/TextView.cpp \
+    src/widgets/TypingSurface.cpp \
     src/ThemeEngine.cpp \
+    src/TokenTable.cpp \
+    src/ValidationSettings.cpp \
+    src/WrapLayout.cpp \
     src/IAddon.cpp
 
 HEADERS += \
     src/include/AddonApi.h \
+    src/include/BackgroundValidator.h \
     src/include/BuiltInPacks.h \
+    src/include/CompiledPack.h \
     src/include/ConfigParser.h \
     src/include/ExportDialog.h \
     src/include/FileUtils.h \
@@ -41,11 +52,18 @@ HEADERS += \
     src/include/KeyboardUtils.h \
     src/include/LanguageManager.h \
     src/include/LoadExerciseDialog.h \
+    src/include/Mistake.h \
+    src/include/PackLoader.h \
+    src/include/PackRegistry.h \
     src/include/Settings.h \
     src/include/StatsDialog.h \
     src/include/StringUtils.h \
     src/include/widgets/TextView.h \
+    src/include/widgets/TypingSurface.h \
     src/include/ThemeEngine.h \
+    src/include/TokenTable.h \
+    src/include/ValidationSettings.h \
+    src/include/WrapLayout.h \
     src/include/IAddon.h
 
 FORMS += \
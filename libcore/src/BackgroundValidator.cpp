@@ -0,0 +1,156 @@
+/*
+ * BackgroundValidator.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtConcurrent>
+#include <QFutureInterface>
+#include "BackgroundValidator.h"
+
+/*! Constructs BackgroundValidator. */
+BackgroundValidator::BackgroundValidator(QObject *parent) :
+	QObject(parent)
+{
+	connect(&watcher, &QFutureWatcherBase::finished, this, &BackgroundValidator::finishValidation);
+}
+
+/*!
+ * Starts validating a new exercise. The input is cleared.\n
+ * mistakeChars, timed and timeSecs have the same meaning as in StringUtils#validateExercise().
+ * Settings aren't read by the validator, because validation runs in other threads.
+ */
+void BackgroundValidator::start(const QString exerciseText, int mistakeChars, bool timed, int timeSecs)
+{
+	active = true;
+	m_exerciseText = exerciseText;
+	m_exerciseText.replace("‘", "'");
+	m_mistakeChars = mistakeChars;
+	m_timed = timed;
+	m_timeSecs = timeSecs;
+	input.clear();
+	recordedCharacters.clear();
+	pending = false;
+	jobStarted = false;
+}
+
+/*! Stops validating. Keystrokes are ignored until start() is called. */
+void BackgroundValidator::stop(void)
+{
+	active = false;
+	pending = false;
+}
+
+/*! Adds a typed character with the number of hits it took to type it. */
+void BackgroundValidator::addCharacter(const QString text, int hits)
+{
+	if(!active)
+		return;
+	QString normalizedText = text;
+	input += normalizedText.replace("‘", "'");
+	recordedCharacters += QPair<QString, int>(text, hits);
+	scheduleValidation();
+}
+
+/*! Removes the last typed character (used by backspace). */
+void BackgroundValidator::removeCharacter(void)
+{
+	if(!active)
+		return;
+	input.chop(1);
+	if(!recordedCharacters.isEmpty())
+		recordedCharacters.removeLast();
+	scheduleValidation();
+}
+
+/*! Removes the last character of the input text, but keeps its hits. */
+void BackgroundValidator::chopInput(void)
+{
+	if(!active)
+		return;
+	input.chop(1);
+	scheduleValidation();
+}
+
+/*!
+ * Returns true if the last background validation was done with the whole input (it may be still running).
+ * In that case result() returns its future.
+ */
+bool BackgroundValidator::hasResult(void) const
+{
+	return jobStarted && (input == jobInput) && (recordedCharacters == jobCharacters);
+}
+
+/*!
+ * Returns the result of the exercise validation with the exercise text and options passed to start()
+ * and the input passed to addCharacter(), removeCharacter() and chopInput().\n
+ * If the last validation was done with the whole input, its future is returned (it may be still running).
+ * Otherwise the exercise is validated in another thread.
+ */
+QFuture<BackgroundValidator::Result> BackgroundValidator::result(void)
+{
+	if(hasResult())
+		return future;
+#ifdef Q_OS_WASM
+	return readyFuture(validate(m_exerciseText, input, recordedCharacters, m_mistakeChars, m_timed, m_timeSecs));
+#else
+	return QtConcurrent::run(&BackgroundValidator::validate, m_exerciseText, input, recordedCharacters, m_mistakeChars, m_timed, m_timeSecs);
+#endif // Q_OS_WASM
+}
+
+/*! Validates the exercise using StringUtils#validateExercise(). Settings aren't read, so this can be used in any thread. */
+BackgroundValidator::Result BackgroundValidator::validate(const QString exerciseText, const QString inputText, const QVector<QPair<QString, int>> recordedCharacters, int mistakeChars, bool timed, int timeSecs)
+{
+	Result result;
+	result.mistakes = StringUtils::validateExercise(exerciseText, inputText, recordedCharacters, &result.totalHits, &result.mistakeCount, &result.errorWords, timed, timeSecs, mistakeChars, &result.bandWidth);
+	return result;
+}
+
+/*! Validates the current input in the background, or after the running validation finishes. */
+void BackgroundValidator::scheduleValidation(void)
+{
+#ifndef Q_OS_WASM
+	if(jobStarted && !future.isFinished())
+	{
+		pending = true;
+		return;
+	}
+	pending = false;
+	jobStarted = true;
+	jobInput = input;
+	jobCharacters = recordedCharacters;
+	future = QtConcurrent::run(&BackgroundValidator::validate, m_exerciseText, jobInput, jobCharacters, m_mistakeChars, m_timed, m_timeSecs);
+	watcher.setFuture(future);
+#endif // Q_OS_WASM
+}
+
+/*! Returns a finished future with the result. */
+QFuture<BackgroundValidator::Result> BackgroundValidator::readyFuture(const Result &result)
+{
+	QFutureInterface<Result> futureInterface;
+	futureInterface.reportStarted();
+	futureInterface.reportResult(result);
+	futureInterface.reportFinished();
+	return futureInterface.future();
+}
+
+/*! Starts the pending validation. */
+void BackgroundValidator::finishValidation(void)
+{
+	if(active && pending)
+		scheduleValidation();
+}
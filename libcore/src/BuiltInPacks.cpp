@@ -44,3 +44,16 @@ QString BuiltInPacks::packName(QString rawName)
 	else
 		return tr("Unknown pack");
 }
+
+/*!
+ * Returns the resource path of the built-in pack.\n
+ * The compiled pack is used if it was generated at build time.
+ * \see CompiledPack
+ */
+QString BuiltInPacks::packPath(QString rawName)
+{
+	QString compiledPath = ":/res/compiled-configs/" + rawName;
+	if(QFile::exists(compiledPath))
+		return compiledPath;
+	return ":/res/configs/" + rawName;
+}
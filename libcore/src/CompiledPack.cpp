@@ -0,0 +1,331 @@
+/*
+ * CompiledPack.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtEndian>
+#include <QHash>
+#include "CompiledPack.h"
+#include "ConfigParser.h"
+
+static const char compiledPackMagic[] = "OTPC";
+
+/*! Appends a 32-bit little endian integer. */
+static void appendValue(QByteArray *out, quint32 value)
+{
+	uchar buffer[4];
+	qToLittleEndian<quint32>(value, buffer);
+	out->append(reinterpret_cast<const char *>(buffer), 4);
+}
+
+/*! Appends offset and length of an interned string (the string is added to the pool if it isn't there yet). */
+static void appendString(QByteArray *out, QByteArray *pool, QHash<QString, quint32> *internedStrings, const QString str)
+{
+	quint32 offset;
+	if(internedStrings->contains(str))
+		offset = internedStrings->value(str);
+	else
+	{
+		offset = pool->size() / 2;
+		internedStrings->insert(str, offset);
+		for(int i = 0; i < str.count(); i++)
+		{
+			uchar buffer[2];
+			qToLittleEndian<quint16>(str[i].unicode(), buffer);
+			pool->append(reinterpret_cast<const char *>(buffer), 2);
+		}
+	}
+	appendValue(out, offset);
+	appendValue(out, str.count());
+}
+
+/*! Converts the pack opened in the given ConfigParser to the compiled pack format. */
+QByteArray CompiledPack::compile(ConfigParser *parser)
+{
+	QByteArray lessonTable, sublessonTable, exerciseTable, pool;
+	QHash<QString, quint32> internedStrings;
+	quint32 sublessonCount = 0, exerciseCount = 0;
+	QList<int> lessons = parser->packIndex.keys();
+	for(int i = 0; i < lessons.count(); i++)
+	{
+		int lesson = lessons[i];
+		QList<int> sublessons = parser->packIndex[lesson].sublessons.keys();
+		appendValue(&lessonTable, lesson);
+		appendValue(&lessonTable, sublessonCount);
+		appendValue(&lessonTable, sublessons.count());
+		appendString(&lessonTable, &pool, &internedStrings, parser->lessonDesc(lesson));
+		for(int j = 0; j < sublessons.count(); j++)
+		{
+			int sublesson = sublessons[j];
+			QList<int> exercises = parser->packIndex[lesson].sublessons[sublesson].keys();
+			appendValue(&sublessonTable, sublesson);
+			appendValue(&sublessonTable, exerciseCount);
+			appendValue(&sublessonTable, exercises.count());
+			for(int k = 0; k < exercises.count(); k++)
+			{
+				int exercise = exercises[k];
+				ExerciseRecord record = parser->exerciseRecord(lesson, sublesson, exercise);
+				QString rawText = parser->exerciseRawText(lesson, sublesson, exercise);
+				appendValue(&exerciseTable, exercise);
+				appendValue(&exerciseTable, parser->exerciseLine(lesson, sublesson, exercise));
+				appendValue(&exerciseTable, record.repeat);
+				appendString(&exerciseTable, &pool, &internedStrings, record.repeatType);
+				appendValue(&exerciseTable, record.repeatLimit);
+				appendValue(&exerciseTable, record.lineLength);
+				appendString(&exerciseTable, &pool, &internedStrings, rawText);
+				appendString(&exerciseTable, &pool, &internedStrings, ConfigParser::initText(rawText));
+				exerciseCount++;
+			}
+			sublessonCount++;
+		}
+	}
+	// Header
+	QByteArray out(compiledPackMagic, 4);
+	quint32 lessonTableOffset = HeaderSize;
+	quint32 sublessonTableOffset = lessonTableOffset + lessonTable.size();
+	quint32 exerciseTableOffset = sublessonTableOffset + sublessonTable.size();
+	quint32 poolOffset = exerciseTableOffset + exerciseTable.size();
+	appendValue(&out, FormatVersion);
+	appendValue(&out, lessons.count());
+	appendValue(&out, sublessonCount);
+	appendValue(&out, exerciseCount);
+	appendValue(&out, lessonTableOffset);
+	appendValue(&out, sublessonTableOffset);
+	appendValue(&out, exerciseTableOffset);
+	appendValue(&out, poolOffset);
+	appendValue(&out, pool.size());
+	out += lessonTable + sublessonTable + exerciseTable + pool;
+	return out;
+}
+
+/*! Returns true if the data starts with the compiled pack magic number. */
+bool CompiledPack::isCompiled(const QByteArray data)
+{
+	return data.startsWith(compiledPackMagic);
+}
+
+/*!
+ * Loads a compiled pack from an opened file.\n
+ * The file is mapped to memory if possible, so the file must stay open until unload() is called.
+ * Strings are returned without copying if the file is a resource.\n
+ * Returns true if successful.
+ */
+bool CompiledPack::load(QFile *file)
+{
+	unload();
+	packSize = file->size();
+	packData = file->map(0, packSize);
+	zeroCopy = file->fileName().startsWith(':');
+	if(!packData)
+	{
+		ownedData = file->readAll();
+		packData = reinterpret_cast<const uchar *>(ownedData.constData());
+		zeroCopy = false;
+	}
+	// Strings in the pool can be used directly only if they're aligned
+	if(reinterpret_cast<quintptr>(packData) % 2 != 0)
+		zeroCopy = false;
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+	zeroCopy = false;
+#endif
+	if((packSize < HeaderSize) || !isCompiled(QByteArray::fromRawData(reinterpret_cast<const char *>(packData), 4)) || (value(4) != FormatVersion))
+	{
+		unload();
+		return false;
+	}
+	quint64 lessonTableEnd = value(20) + (quint64) value(8) * LessonEntrySize;
+	quint64 sublessonTableEnd = value(24) + (quint64) value(12) * SublessonEntrySize;
+	quint64 exerciseTableEnd = value(28) + (quint64) value(16) * ExerciseEntrySize;
+	quint64 poolEnd = value(32) + (quint64) value(36);
+	if((lessonTableEnd > (quint64) packSize) || (sublessonTableEnd > (quint64) packSize) || (exerciseTableEnd > (quint64) packSize) || (poolEnd > (quint64) packSize))
+	{
+		unload();
+		return false;
+	}
+	return true;
+}
+
+/*! Unloads the compiled pack. */
+void CompiledPack::unload(void)
+{
+	packData = nullptr;
+	packSize = 0;
+	ownedData.clear();
+	zeroCopy = false;
+}
+
+/*! Returns true if there's a compiled pack loaded. */
+bool CompiledPack::isLoaded(void)
+{
+	return packData != nullptr;
+}
+
+/*! Returns the number of lessons. \see ConfigParser#lessonCount() */
+int CompiledPack::lessonCount(void)
+{
+	if(!isLoaded())
+		return 0;
+	return value(8);
+}
+
+/*! Returns the number of sublessons in a lesson. \see ConfigParser#sublessonCount() */
+int CompiledPack::sublessonCount(int lesson)
+{
+	int lessonIndex = findLesson(lesson);
+	if(lessonIndex == -1)
+		return 0;
+	return value(value(20) + lessonIndex * LessonEntrySize + 8);
+}
+
+/*! Returns the number of exercises in a sublesson. \see ConfigParser#exerciseCount() */
+int CompiledPack::exerciseCount(int lesson, int sublesson)
+{
+	int sublessonIndex = findSublesson(lesson, sublesson);
+	if(sublessonIndex == -1)
+		return 0;
+	return value(value(24) + sublessonIndex * SublessonEntrySize + 8);
+}
+
+/*! Returns the line the exercise is located in the source pack file. \see ConfigParser#exerciseLine() */
+int CompiledPack::exerciseLine(int lesson, int sublesson, int exercise)
+{
+	quint32 entry = findExercise(lesson, sublesson, exercise);
+	return entry ? value(entry + 4) : 0;
+}
+
+/*! Returns true if repeating is enabled in the exercise. \see ConfigParser#exerciseRepeatBool() */
+bool CompiledPack::exerciseRepeatBool(int lesson, int sublesson, int exercise)
+{
+	quint32 entry = findExercise(lesson, sublesson, exercise);
+	return entry ? value(entry + 8) : false;
+}
+
+/*! Returns repeat configuration of the exercise. \see ConfigParser#exerciseRepeatType() */
+QString CompiledPack::exerciseRepeatType(int lesson, int sublesson, int exercise)
+{
+	quint32 entry = findExercise(lesson, sublesson, exercise);
+	return entry ? string(entry + 12) : QString();
+}
+
+/*! Returns the maximum number of characters of the exercise. \see ConfigParser#exerciseRepeatLimit() */
+int CompiledPack::exerciseRepeatLimit(int lesson, int sublesson, int exercise)
+{
+	quint32 entry = findExercise(lesson, sublesson, exercise);
+	return entry ? value(entry + 20) : 0;
+}
+
+/*! Returns the exercise's maximum number of characters in one line. \see ConfigParser#exerciseLineLength() */
+int CompiledPack::exerciseLineLength(int lesson, int sublesson, int exercise)
+{
+	quint32 entry = findExercise(lesson, sublesson, exercise);
+	return entry ? value(entry + 24) : 0;
+}
+
+/*! Returns the description of a lesson. \see ConfigParser#lessonDesc() */
+QString CompiledPack::lessonDesc(int lesson)
+{
+	int lessonIndex = findLesson(lesson);
+	if(lessonIndex == -1)
+		return "";
+	return string(value(20) + lessonIndex * LessonEntrySize + 12);
+}
+
+/*! Returns raw text of the exercise. \see ConfigParser#exerciseRawText() */
+QString CompiledPack::exerciseRawText(int lesson, int sublesson, int exercise)
+{
+	quint32 entry = findExercise(lesson, sublesson, exercise);
+	return entry ? string(entry + 28) : QString();
+}
+
+/*! Returns exercise text without escape sequences (and without repeating). \see ConfigParser#initText() */
+QString CompiledPack::exerciseText(int lesson, int sublesson, int exercise)
+{
+	quint32 entry = findExercise(lesson, sublesson, exercise);
+	return entry ? string(entry + 36) : QString();
+}
+
+/*! Returns the 32-bit integer at the given offset. */
+quint32 CompiledPack::value(quint32 offset)
+{
+	return qFromLittleEndian<quint32>(packData + offset);
+}
+
+/*! Returns the string with offset and length stored at the given offset. */
+QString CompiledPack::string(quint32 offset)
+{
+	quint32 stringOffset = value(offset);
+	quint32 length = value(offset + 4);
+	if((stringOffset + (quint64) length) * 2 > value(36))
+		return QString();
+	const uchar *src = packData + value(32) + stringOffset * 2;
+	if(zeroCopy)
+		return QString::fromRawData(reinterpret_cast<const QChar *>(src), length);
+	QString out(length, Qt::Uninitialized);
+	for(quint32 i = 0; i < length; i++)
+		out[i] = QChar(qFromLittleEndian<quint16>(src + i * 2));
+	return out;
+}
+
+/*! Returns the index of the entry with the given ID (entries are sorted by ID), or -1 if there isn't such entry. */
+int CompiledPack::findEntry(quint32 tableOffset, quint32 entrySize, quint32 first, quint32 count, int id)
+{
+	quint32 low = first, high = first + count;
+	while(low < high)
+	{
+		quint32 mid = low + (high - low) / 2;
+		int midID = (qint32) value(tableOffset + mid * entrySize);
+		if(midID < id)
+			low = mid + 1;
+		else if(midID > id)
+			high = mid;
+		else
+			return mid;
+	}
+	return -1;
+}
+
+/*! Returns the index of the lesson in the lesson table. */
+int CompiledPack::findLesson(int lesson)
+{
+	if(!isLoaded())
+		return -1;
+	return findEntry(value(20), LessonEntrySize, 0, value(8), lesson);
+}
+
+/*! Returns the index of the sublesson in the sublesson table. */
+int CompiledPack::findSublesson(int lesson, int sublesson)
+{
+	int lessonIndex = findLesson(lesson);
+	if(lessonIndex == -1)
+		return -1;
+	quint32 lessonEntry = value(20) + lessonIndex * LessonEntrySize;
+	return findEntry(value(24), SublessonEntrySize, value(lessonEntry + 4), value(lessonEntry + 8), sublesson);
+}
+
+/*! Returns the offset of the exercise entry, or 0 if there isn't such exercise. */
+quint32 CompiledPack::findExercise(int lesson, int sublesson, int exercise)
+{
+	int sublessonIndex = findSublesson(lesson, sublesson);
+	if(sublessonIndex == -1)
+		return 0;
+	quint32 sublessonEntry = value(24) + sublessonIndex * SublessonEntrySize;
+	int exerciseIndex = findEntry(value(28), ExerciseEntrySize, value(sublessonEntry + 4), value(sublessonEntry + 8), exercise);
+	if(exerciseIndex == -1)
+		return 0;
+	return value(28) + exerciseIndex * ExerciseEntrySize;
+}
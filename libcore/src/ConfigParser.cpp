@@ -18,7 +18,11 @@
  * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+#include <QFileInfo>
+#include <QDateTime>
 #include "ConfigParser.h"
+#include "TokenTable.h"
 
 namespace publicPos {
 	int currentLesson = 0, currentSublesson = 0, currentExercise = 0;
@@ -29,19 +33,27 @@ ConfigParser::ConfigParser(QObject *parent) :
 	QObject(parent)
 {
 	currentDevice = &configFile;
+	textCache.setMaxCost(textCacheMaxCost);
 }
 
 /*!
  * Opens a pack file.\n
+ * If the file is a compiled pack (see CompiledPack), it's opened read-only.\n
  * Returns true if successful.
  * \see reopen()
  */
 bool ConfigParser::open(const QString fileName)
 {
-	currentDevice->close();
+	close();
 	configFile.setFileName(fileName);
 	currentDevice = &configFile;
-	return configFile.open(QIODevice::ReadOnly | QIODevice::Text);
+	bool ret = configFile.open(QIODevice::ReadOnly);
+	updatePackId();
+	if(ret && CompiledPack::isCompiled(configFile.peek(4)))
+		return compiledPack.load(&configFile);
+	configFile.setTextModeEnabled(true);
+	buildIndex();
+	return ret;
 }
 
 /*! Closes opened file and loads pack content to the buffer. */
@@ -54,6 +66,28 @@ void ConfigParser::loadToBuffer(const QByteArray content)
 	configBuffer.close();
 	configBuffer.open(QIODevice::ReadOnly);
 	currentDevice = &configBuffer;
+	invalidateTextCache();
+	buildIndex();
+}
+
+/*!
+ * Appends data to the opened buffer and indexes the new lines.\n
+ * This is used to load large packs incrementally (see PackLoader), so data should end with a new line.
+ * Returns false if there's no buffer opened.
+ */
+bool ConfigParser::appendToBuffer(const QByteArray data)
+{
+	if(currentDevice != &configBuffer)
+		return false;
+	unmapPack();
+	configBuffer.buffer().append(data);
+	invalidateTextCache();
+	// The last line is indexed again if there wasn't a new line at the end
+	if(indexTerminated)
+		updateIndex();
+	else
+		buildIndex();
+	return true;
 }
 
 /*! Returns current data in the opened file or buffer. */
@@ -98,6 +132,8 @@ bool ConfigParser::reopen(QIODevice::OpenMode mode)
 /*! Closes the opened pack file or buffer. */
 void ConfigParser::close(void)
 {
+	compiledPack.unload();
+	clearIndex();
 	currentDevice->close();
 }
 
@@ -113,18 +149,9 @@ QString ConfigParser::fileName(void)
 /*! Returns the number of lessons in the pack file or buffer. */
 int ConfigParser::lessonCount(void)
 {
-	if(!currentDevice->isReadable())
-		return 0;
-	currentDevice->seek(0);
-	QList<int> lessonIDs;
-	while(!currentDevice->atEnd())
-	{
-		QString line = QString(currentDevice->readLine()).remove('\n');
-		int lessonID = exerciseID(line, 1);
-		if(!lessonIDs.contains(lessonID))
-			lessonIDs += lessonID;
-	}
-	return lessonIDs.count();
+	if(compiledPack.isLoaded())
+		return compiledPack.lessonCount();
+	return packIndex.count();
 }
 
 /*!
@@ -134,47 +161,19 @@ int ConfigParser::lessonCount(void)
  */
 int ConfigParser::sublessonCount(int lesson)
 {
-	if(!currentDevice->isReadable())
-		return 0;
-	currentDevice->seek(0);
-	QList<int> sublessonIDs;
-	while(!currentDevice->atEnd())
-	{
-		QString line = QString(currentDevice->readLine()).remove('\n');
-		int lessonID = exerciseID(line, 1);
-		if(lessonID == lesson)
-		{
-			int sublessonID = exerciseID(line, 2);
-			if(!sublessonIDs.contains(sublessonID))
-				sublessonIDs += sublessonID;
-		}
-	}
-	return sublessonIDs.count();
+	if(compiledPack.isLoaded())
+		return compiledPack.sublessonCount(lesson);
+	return packIndex.value(lesson).sublessons.count();
 }
 
 /*! Returns the number of exercises in a sublesson. */
 int ConfigParser::exerciseCount(int lesson, int sublesson)
 {
-	if(!currentDevice->isReadable())
+	if(compiledPack.isLoaded())
+		return compiledPack.exerciseCount(lesson, sublesson);
+	if(!packIndex.contains(lesson))
 		return 0;
-	currentDevice->seek(0);
-	QList<int> exerciseIDs;
-	while(!currentDevice->atEnd())
-	{
-		QString line = QString(currentDevice->readLine()).remove('\n');
-		int lessonID = exerciseID(line, 1);
-		if(lessonID == lesson)
-		{
-			int sublessonID = exerciseID(line, 2);
-			if(sublessonID == sublesson)
-			{
-				int _exerciseID = exerciseID(line, 3);
-				if(!exerciseIDs.contains(_exerciseID))
-					exerciseIDs += _exerciseID;
-			}
-		}
-	}
-	return exerciseIDs.count();
+	return packIndex[lesson].sublessons.value(sublesson).count();
 }
 
 /*! Returns the line the exercise is located in the pack file or buffer. */
@@ -182,59 +181,79 @@ int ConfigParser::exerciseLine(int lesson, int sublesson, int exercise)
 {
 	if(!currentDevice->isReadable())
 		return -1;
-	currentDevice->seek(0);
-	int lineID = 0;
-	while(!currentDevice->atEnd())
-	{
-		lineID++;
-		QString line = QString(currentDevice->readLine()).remove('\n');
-		if((exerciseID(line, 1) == lesson) && (exerciseID(line, 2) == sublesson) && (exerciseID(line, 3) == exercise))
-			return lineID;
-	}
+	if(compiledPack.isLoaded())
+		return compiledPack.exerciseLine(lesson, sublesson, exercise);
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	if(target)
+		return target->line;
 	return 0;
 }
 
 /*! Returns true if repeating is enabled in the exercise. */
 bool ConfigParser::exerciseRepeatBool(int lesson, int sublesson, int exercise)
 {
-	return exerciseRepeatBool(exerciseRepeatConfig(lineOf(lesson, sublesson, exercise)));
+	if(compiledPack.isLoaded())
+		return compiledPack.exerciseRepeatBool(lesson, sublesson, exercise);
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	return target ? target->record.repeat : false;
 }
 
 /*! Returns repeat configuration of the exercise. */
 QString ConfigParser::exerciseRepeatType(int lesson, int sublesson, int exercise)
 {
-	return exerciseRepeatType(exerciseRepeatConfig(lineOf(lesson, sublesson, exercise)));
+	if(compiledPack.isLoaded())
+		return compiledPack.exerciseRepeatType(lesson, sublesson, exercise);
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	return target ? target->record.repeatType : QString();
 }
 
 /*! Returns the maximum number of characters of the exercise (if repeating is enabled). */
 int ConfigParser::exerciseRepeatLimit(int lesson, int sublesson, int exercise)
 {
-	return exerciseAttribute(exerciseAttributes(lineOf(lesson, sublesson, exercise)), 0).toInt();
+	if(compiledPack.isLoaded())
+		return compiledPack.exerciseRepeatLimit(lesson, sublesson, exercise);
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	return target ? target->record.repeatLimit : 0;
 }
 
 /*! Returns the exercise's maximum number of characters in one line. */
 int ConfigParser::exerciseLineLength(int lesson, int sublesson, int exercise)
 {
-	return exerciseAttribute(exerciseAttributes(lineOf(lesson, sublesson, exercise)), 1).toInt();
+	if(compiledPack.isLoaded())
+		return compiledPack.exerciseLineLength(lesson, sublesson, exercise);
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	return target ? target->record.lineLength : 0;
 }
 
-/*! Returns the description of a lesson (what new characters are learned in it). */
-QString ConfigParser::lessonDesc(int lesson)
+/*!
+ * Returns all fields of the exercise at once.\n
+ * Use this instead of calling the separate accessors if more fields are needed.
+ * \see parseExerciseLine()
+ */
+ExerciseRecord ConfigParser::exerciseRecord(int lesson, int sublesson, int exercise)
 {
-	if(!currentDevice->isReadable())
-		return "";
-	currentDevice->seek(0);
-	while(!currentDevice->atEnd())
+	if(compiledPack.isLoaded())
 	{
-		QString line = QString(currentDevice->readLine()).remove('\n');
-		if(exerciseID(line, 1) == lesson)
-		{
-			QString out = exerciseAttribute(exerciseAttributes(line), 2);
-			if(out != "")
-				return out;
-		}
+		ExerciseRecord record;
+		record.lesson = lesson;
+		record.sublesson = sublesson;
+		record.exercise = exercise;
+		record.repeat = compiledPack.exerciseRepeatBool(lesson, sublesson, exercise);
+		record.repeatType = compiledPack.exerciseRepeatType(lesson, sublesson, exercise);
+		record.repeatLimit = compiledPack.exerciseRepeatLimit(lesson, sublesson, exercise);
+		record.lineLength = compiledPack.exerciseLineLength(lesson, sublesson, exercise);
+		return record;
 	}
-	return "";
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	return target ? target->record : ExerciseRecord();
+}
+
+/*! Returns the description of a lesson (what new characters are learned in it). */
+QString ConfigParser::lessonDesc(int lesson)
+{
+	if(compiledPack.isLoaded())
+		return compiledPack.lessonDesc(lesson);
+	return packIndex.value(lesson).desc;
 }
 
 /*!
@@ -346,7 +365,12 @@ QString ConfigParser::exerciseTr(int id)
  */
 QString ConfigParser::exerciseRawText(int lesson, int sublesson, int exercise)
 {
-	return exerciseRawText(lineOf(lesson, sublesson, exercise));
+	if(compiledPack.isLoaded())
+		return compiledPack.exerciseRawText(lesson, sublesson, exercise);
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	if(!target)
+		return "";
+	return rawText(lineOf(lesson, sublesson, exercise), target->record);
 }
 
 /*!
@@ -356,13 +380,79 @@ QString ConfigParser::exerciseRawText(int lesson, int sublesson, int exercise)
  */
 QString ConfigParser::exerciseText(int lesson, int sublesson, int exercise)
 {
-	QString line = lineOf(lesson, sublesson, exercise);
-	QString repeatConfig = exerciseRepeatConfig(line);
-	QString attributes = exerciseAttributes(line);
-	return generateText(exerciseRawText(line),
-		exerciseRepeatBool(repeatConfig),
-		exerciseRepeatType(repeatConfig),
-		exerciseAttribute(attributes, 0).toInt());
+	QString key = textCacheKey(lesson, sublesson, exercise, -1);
+	{
+		QMutexLocker locker(&textCacheMutex);
+		QString *cached = textCache.object(key);
+		if(cached)
+		{
+			cacheHits++;
+			return *cached;
+		}
+		cacheMisses++;
+	}
+	QString out;
+	if(compiledPack.isLoaded())
+	{
+		// Compiled packs contain text without escape sequences, only word repeating has to be done
+		if(compiledPack.exerciseRepeatBool(lesson, sublesson, exercise) && (compiledPack.exerciseRepeatType(lesson, sublesson, exercise) == "w"))
+			out = generateText(compiledPack.exerciseRawText(lesson, sublesson, exercise), true, "w", compiledPack.exerciseRepeatLimit(lesson, sublesson, exercise));
+		else
+			out = compiledPack.exerciseText(lesson, sublesson, exercise);
+	}
+	else
+	{
+		const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+		if(target)
+		{
+			out = generateText(rawText(lineOf(lesson, sublesson, exercise), target->record),
+				target->record.repeat,
+				target->record.repeatType,
+				target->record.repeatLimit);
+		}
+	}
+	QMutexLocker locker(&textCacheMutex);
+	textCache.insert(key, new QString(out), out.count());
+	return out;
+}
+
+/*!
+ * Returns exercise text with repeating and line wrapping.\n
+ * It's the same as initExercise(exerciseText(lesson, sublesson, exercise), lineLength), but the result is cached.
+ * \see exerciseText()
+ * \see initExercise()
+ */
+QString ConfigParser::wrappedExerciseText(int lesson, int sublesson, int exercise, int lineLength)
+{
+	QString key = textCacheKey(lesson, sublesson, exercise, lineLength);
+	{
+		QMutexLocker locker(&textCacheMutex);
+		QString *cached = textCache.object(key);
+		if(cached)
+		{
+			cacheHits++;
+			return *cached;
+		}
+		cacheMisses++;
+	}
+	QString out = initExercise(exerciseText(lesson, sublesson, exercise), lineLength);
+	QMutexLocker locker(&textCacheMutex);
+	textCache.insert(key, new QString(out), out.count());
+	return out;
+}
+
+/*! Returns the number of exerciseText() and wrappedExerciseText() calls answered from the cache. */
+int ConfigParser::textCacheHits(void)
+{
+	QMutexLocker locker(&textCacheMutex);
+	return cacheHits;
+}
+
+/*! Returns the number of exerciseText() and wrappedExerciseText() calls which had to generate the text. */
+int ConfigParser::textCacheMisses(void)
+{
+	QMutexLocker locker(&textCacheMutex);
+	return cacheMisses;
 }
 
 /*!
@@ -447,219 +537,252 @@ QString ConfigParser::initText(QString rawText)
 	return generateText(rawText, false, "", 0);
 }
 
-/*! Implementation of exerciseRepeatBool() for a config string. */
-bool ConfigParser::exerciseRepeatBool(const QString config)
-{
-	QString out = "";
-	int i;
-	for(i = 0; i < config.count(); i++)
-	{
-		if(config[i] == '\\')
-		{
-			i++;
-			if(i < config.count())
-				out += config[i];
-		}
-		else if(config[i] == ',')
-			return (out == "1");
-		else
-			out += config[i];
-	}
-	return "";
-}
-
-/*! Implementation of exerciseRepeatType() for a config string. */
-QString ConfigParser::exerciseRepeatType(const QString config)
-{
-	QString out = "";
-	bool repeatTypeReached = false;
-	int i;
-	for(i = 0; i < config.count(); i++)
-	{
-		if(config[i] == '\\')
-		{
-			i++;
-			if(i < config.count())
-				out += config[i];
-		}
-		else if(config[i] == ',')
-			repeatTypeReached = true;
-		else
-		{
-			if(repeatTypeReached)
-				out += config[i];
-		}
-	}
-	return out;
-}
-
-/*! Gets config string from a line. */
-QString ConfigParser::exerciseRepeatConfig(const QString line)
-{
-	QString out = "";
-	bool repeatConfigReached = false;
-	int i;
-	for(i = 0; i < line.count(); i++)
+/*!
+ * Parses an exercise line in a single pass.\n
+ * The exercise text isn't copied, see ExerciseRecord#textPos.
+ * \see rawText()
+ */
+ExerciseRecord ConfigParser::parseExerciseLine(const QString line)
+{
+	ExerciseRecord record;
+	QString id, repeatFlag, attribute;
+	int idPart = 0, attributeID = 0;
+	bool separatorSkipped = false, repeatConfigReached = false, repeatTypeReached = false, attributesReached = false;
+	int i, count = line.count();
+	record.textPos = count;
+	auto finishID = [&record, &id, &idPart]() {
+		if(idPart == 0)
+			record.lesson = id.toInt();
+		else if(idPart == 1)
+			record.sublesson = id.toInt();
+		else if(idPart == 2)
+			record.exercise = id.toInt();
+		idPart++;
+		id = "";
+	};
+	auto finishAttribute = [&record, &attribute, &attributeID]() {
+		if(attributeID == 0)
+			record.repeatLimit = attribute.toInt();
+		else if(attributeID == 1)
+			record.lineLength = attribute.toInt();
+		else if(attributeID == 2)
+			record.desc = attribute;
+		attributeID++;
+		attribute = "";
+	};
+	for(i = 0; i < count; i++)
 	{
-		if(line[i] == '\\')
+		QChar c = line[i];
+		bool escaped = (c == '\\');
+		if(escaped)
 		{
 			i++;
-			if(i < line.count())
-				out += line[i];
+			if(i >= count)
+				break;
+			c = line[i];
 		}
-		else if(line[i] == ':')
-			repeatConfigReached = true;
-		else if((line[i] == ' ') || (line[i] == ';'))
-			return out;
-		else
+		else if(c == ' ')
 		{
-			if(repeatConfigReached)
-				out += line[i];
+			// The exercise text starts after the first space
+			record.textPos = i + 1;
+			break;
 		}
-	}
-	return out;
-}
-
-/*! Gets a specific exercise attribute from a config string. */
-QString ConfigParser::exerciseAttribute(const QString config, const int id)
-{
-	QString out = "";
-	int i, currentID = 0;
-	for(i = 0; i < config.count(); i++)
-	{
-		if(config[i] == '\\')
+		// Exercise ID (lesson.sublesson.exercise)
+		if(idPart < 3)
 		{
-			i++;
-			if(i < config.count())
-				out += config[i];
+			// The character after a separator always belongs to the next part
+			if(!escaped && !separatorSkipped && ((c == '.') || (c == ':')))
+			{
+				finishID();
+				separatorSkipped = true;
+			}
+			else
+			{
+				id += c;
+				separatorSkipped = false;
+			}
 		}
-		else if(config[i] == ',')
+		// Repeat config (repeat flag and type) and attributes (repeat limit, line length and description)
+		if(!escaped && (c == ';'))
 		{
-			if(currentID == id)
-				return out;
-			out = "";
-			currentID++;
+			if(attributesReached)
+				continue;
+			attributesReached = true;
 		}
-		else
-			out += config[i];
-	}
-	if(currentID == id)
-		return out;
-	else
-		return "";
-}
-
-/*! Gets a config string from a line. */
-QString ConfigParser::exerciseAttributes(const QString line)
-{
-	QString out = "";
-	bool lengthConfigReached = false;
-	int i;
-	for(i = 0; i < line.count(); i++)
-	{
-		if(line[i] == '\\')
+		else if(attributesReached)
 		{
-			i++;
-			if(i < line.count())
-				out += '\\' + line[i];
+			if(!escaped && (c == ','))
+				finishAttribute();
+			else
+				attribute += c;
 		}
-		else if(line[i] == ';')
-			lengthConfigReached = true;
-		else if(line[i] == ' ')
-			return out;
-		else
+		else if(!escaped && (c == ':'))
+			repeatConfigReached = true;
+		else if(repeatConfigReached)
 		{
-			if(lengthConfigReached)
-				out += line[i];
+			if(c == ',')
+				repeatTypeReached = true;
+			else if(repeatTypeReached)
+				record.repeatType += c;
+			else
+				repeatFlag += c;
 		}
 	}
-	return out;
-}
-
-/*! Implementation of exerciseRawText() for a line. */
-QString ConfigParser::exerciseRawText(const QString line)
-{
-	QString out = "";
-	bool textReached = false;
-	int i;
-	for(i = 0; i < line.count(); i++)
+	if(idPart < 3)
+		finishID();
+	if(attributesReached)
+		finishAttribute();
+	// Exercises without a repeat type are repeated
+	record.repeat = repeatTypeReached ? (repeatFlag == "1") : true;
+	return record;
+}
+
+/*! Returns raw text of the exercise from the parsed line. \see exerciseRawText() */
+QString ConfigParser::rawText(const QString line, const ExerciseRecord &record)
+{
+	QString out;
+	int i, end = line.count();
+	out.reserve(end - record.textPos);
+	for(i = record.textPos; i < end; i++)
 	{
 		if(line[i] == '\\')
 		{
 			i++;
-			if(i < line.count())
+			if(i < end)
 			{
 				if(line[i] == 'n')
 					out += "\\n";
-				else if(textReached)
+				else
 					out += line[i];
 			}
 		}
-		else if((line[i] == ' ') && !textReached)
-			textReached = true;
 		else
-		{
-			if(textReached)
-				out += line[i];
-		}
+			out += line[i];
 	}
 	return out;
 }
 
-/*! Returns a part of the exercise ID (from a line).
- *
- * Part 1 - lesson ID\n
- * Part 2 - sublesson ID\n
- * Part 3 - exercise ID\n
+/*! Returns line string of the exercise. */
+QString ConfigParser::lineOf(int lesson, int sublesson, int exercise)
+{
+	const IndexedExercise *target = indexedExercise(lesson, sublesson, exercise);
+	if(!target || !packData)
+		return "";
+	// Only this line is decoded
+	return QString::fromUtf8(packData + target->offset, target->length);
+}
+
+/*! Returns the indexed exercise, or nullptr if there isn't such exercise. */
+const ConfigParser::IndexedExercise *ConfigParser::indexedExercise(int lesson, int sublesson, int exercise)
+{
+	auto lessonIt = packIndex.constFind(lesson);
+	if(lessonIt == packIndex.constEnd())
+		return nullptr;
+	auto sublessonIt = lessonIt->sublessons.constFind(sublesson);
+	if(sublessonIt == lessonIt->sublessons.constEnd())
+		return nullptr;
+	auto exerciseIt = sublessonIt->constFind(exercise);
+	if(exerciseIt == sublessonIt->constEnd())
+		return nullptr;
+	return &exerciseIt.value();
+}
+
+/*!
+ * Reads the whole pack file or buffer and builds the index.\n
+ * Only the first occurrence of each exercise is indexed.
+ * \see updateIndex()
  */
-int ConfigParser::exerciseID(const QString line, const int part)
+void ConfigParser::buildIndex(void)
 {
-	QString out = "";
-	int i, currentPart = 0;
-	for(i = 0; i < line.count(); i++)
+	clearIndex();
+	updateIndex();
+}
+
+/*! Adds lines which were appended after the index was built to the index. */
+void ConfigParser::updateIndex(void)
+{
+	if(!mapPack())
+		return;
+	qint64 pos = indexedSize;
+	while(pos < packSize)
 	{
-		if(line[i] == '\\')
+		const char *line = packData + pos;
+		const char *lineEnd = static_cast<const char *>(memchr(line, '\n', packSize - pos));
+		indexTerminated = (lineEnd != nullptr);
+		qint64 length = indexTerminated ? lineEnd - line : packSize - pos;
+		qint64 nextLine = pos + length + (indexTerminated ? 1 : 0);
+		if((length > 0) && (line[length - 1] == '\r'))
+			length--;
+		indexedLines++;
+		ExerciseRecord record = parseHeader(line, length);
+		IndexedLesson &lesson = packIndex[record.lesson];
+		if(lesson.desc == "")
+			lesson.desc = record.desc;
+		QMap<int, IndexedExercise> &sublesson = lesson.sublessons[record.sublesson];
+		if(!sublesson.contains(record.exercise))
 		{
-			i++;
-			out += line[i];
-		}
-		else
-		{
-			if((line[i] == '.') || (line[i] == ' ') || (line[i] == ':'))
-			{
-				currentPart++;
-				/*
-				 * 1: lesson ID
-				 * 2: sublesson ID
-				 * 3: exercise ID
-				 */
-				if(currentPart == part)
-					return out.toInt();
-				out = "";
-				i++;
-			}
-			out += line[i];
+			IndexedExercise exercise;
+			exercise.line = indexedLines;
+			exercise.offset = pos;
+			exercise.length = length;
+			exercise.record = record;
+			sublesson.insert(record.exercise, exercise);
 		}
+		pos = nextLine;
 	}
-	if(currentPart + 1 == part)
-		return out.toInt();
-	else
-		return 0;
+	indexedSize = packSize;
 }
 
-/*! Returns line string of the exercise. */
-QString ConfigParser::lineOf(int lesson, int sublesson, int exercise)
+/*!
+ * Makes the content of the opened file or buffer accessible through packData.\n
+ * Files are mapped to memory (if possible), buffers are used directly.
+ * Returns false if there's nothing opened.
+ */
+bool ConfigParser::mapPack(void)
 {
+	unmapPack();
 	if(!currentDevice->isReadable())
-		return "";
-	currentDevice->seek(0);
-	while(!currentDevice->atEnd())
+		return false;
+	if(currentDevice == &configBuffer)
 	{
-		QString line = QString(currentDevice->readLine()).remove('\n');
-		if((exerciseID(line, 1) == lesson) && (exerciseID(line, 2) == sublesson) && (exerciseID(line, 3) == exercise))
-			return line;
+		packData = configBuffer.buffer().constData();
+		packSize = configBuffer.buffer().size();
+		return true;
 	}
-	return "";
+	packSize = configFile.size();
+	mappedData = configFile.map(0, packSize);
+	if(mappedData)
+		packData = reinterpret_cast<const char *>(mappedData);
+	else
+	{
+		// Fall back to reading the file (for example if it's a compressed resource)
+		configFile.seek(0);
+		packContent = configFile.readAll();
+		packData = packContent.constData();
+		packSize = packContent.size();
+	}
+	return true;
+}
+
+/*! Releases the mapped file or the copy of its content. */
+void ConfigParser::unmapPack(void)
+{
+	if(mappedData)
+		configFile.unmap(mappedData);
+	mappedData = nullptr;
+	packData = nullptr;
+	packSize = 0;
+	packContent.clear();
+}
+
+/*! Removes everything from the index. */
+void ConfigParser::clearIndex(void)
+{
+	unmapPack();
+	packIndex.clear();
+	indexedLines = 0;
+	indexedSize = 0;
+	indexTerminated = true;
 }
 
 /*!
@@ -672,12 +795,24 @@ QString ConfigParser::generateText(QString rawText, bool repeat, QString repeatT
 	{
 		if(rawText == "")
 			return "";
-		int i, words = StringUtils::wordCount(rawText);
+		// Split the words once, StringUtils::word() would read the text from the beginning for every word
+		TokenTable table(rawText);
+		QStringList wordList;
+		int i;
+		for(i = 0; i < table.wordCount(); i++)
+			wordList += table.wordText(i);
+		// A space at the end of the text belongs to the last word
+		if(rawText.endsWith(' '))
+		{
+			wordList.removeLast();
+			wordList.last() += ' ';
+		}
+		int words = wordList.count();
 		QString out = "";
 		i = 1;
 		while(true)
 		{
-			QString nextWord = StringUtils::word(rawText, i);
+			QString nextWord = (i <= wordList.count()) ? wordList[i - 1] : QString();
 			int space = 0;
 			if(out.count() > 0)
 				space = 1; // for space between current text and new word
@@ -730,21 +865,108 @@ QString ConfigParser::generateText(QString rawText, bool repeat, QString repeatT
  */
 bool ConfigParser::addExercise(int lesson, int sublesson, int exercise, bool repeat, QString repeatType, int repeatLimit, int lineLength, QString desc, QString rawText)
 {
-	// Reopen for appending
-	if(!reopen(QIODevice::Append | QIODevice::Text))
+	// Compiled packs are read-only
+	if(compiledPack.isLoaded())
 		return false;
-	// Add exercise line
-	currentDevice->write(QString(QString::number(lesson) + "." + QString::number(sublesson) + "." + QString::number(exercise) + ":").toUtf8());
+	QByteArray line = formatExercise(lesson, sublesson, exercise, repeat, repeatType, repeatLimit, lineLength, desc, rawText);
+	unmapPack();
+	if(currentDevice == &configBuffer)
+	{
+		// Buffers don't have to be reopened
+		configBuffer.buffer().append(line);
+	}
+	else
+	{
+		// Reopen for appending
+		if(!reopen(QIODevice::Append | QIODevice::Text))
+			return false;
+		currentDevice->write(line);
+		// Reopen for reading
+		if(!reopen(QIODevice::ReadOnly | QIODevice::Text)) // This shouldn't happen
+		{
+			clearIndex();
+			return false;
+		}
+	}
+	invalidateTextCache();
+	// Index the new line (it's joined with the last line if there isn't a new line at the end)
+	if(indexTerminated)
+		updateIndex();
+	else
+		buildIndex();
+	return true;
+}
+
+/*!
+ * Returns an exercise line (with a new line at the end) in the pack file format.\n
+ * The parameters are the same as in addExercise(). This can be used to write a whole pack without indexing it.
+ * \see addExercise()
+ */
+QByteArray ConfigParser::formatExercise(int lesson, int sublesson, int exercise, bool repeat, QString repeatType, int repeatLimit, int lineLength, QString desc, QString rawText)
+{
+	QString out = QString::number(lesson) + "." + QString::number(sublesson) + "." + QString::number(exercise) + ":";
 	if(repeat)
-		currentDevice->write("1");
+		out += "1";
 	else
-		currentDevice->write("0");
-	currentDevice->write(QString("," + repeatType + ";" + QString::number(repeatLimit) + "," + QString::number(lineLength)).toUtf8());
+		out += "0";
+	out += "," + repeatType + ";" + QString::number(repeatLimit) + "," + QString::number(lineLength);
 	if(desc != "")
-		currentDevice->write(QString("," + desc).toUtf8());
-	currentDevice->write(QString(" " + rawText + '\n').toUtf8());
-	// Reopen for reading
-	if(!reopen(QIODevice::ReadOnly | QIODevice::Text)) // This shouldn't happen
-		return false;
-	return true;
+		out += "," + desc;
+	out += " " + rawText + '\n';
+	return out.toUtf8();
+}
+
+/*!
+ * Parses the part of a pack line before the exercise text. Only this part is decoded.
+ * \see parseExerciseLine()
+ */
+ExerciseRecord ConfigParser::parseHeader(const char *line, qint64 length)
+{
+	qint64 headerLength = 0;
+	while((headerLength < length) && (line[headerLength] != ' '))
+	{
+		if(line[headerLength] == '\\')
+			headerLength++;
+		headerLength++;
+	}
+	headerLength = std::min(headerLength, length);
+	// The space is included, so that the text position is known
+	return parseExerciseLine(QString::fromUtf8(line, std::min(headerLength + 1, length)));
+}
+
+/*! Updates the identity of the opened pack, which is a part of text cache keys. */
+void ConfigParser::updatePackId(void)
+{
+	if(currentDevice == &configBuffer)
+		packId = "buffer";
+	else
+	{
+		// Include the size and modification time, so that changes of the file aren't missed when it's opened again
+		QFileInfo fileInfo(configFile.fileName());
+		packId = fileInfo.absoluteFilePath() + ":" + QString::number(fileInfo.size()) + ":" + QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
+	}
+	packId += ":" + QString::number(packRevision);
+}
+
+/*!
+ * Removes cached text of the opened pack.\n
+ * This is called when the pack changes (see loadToBuffer() and addExercise()).
+ */
+void ConfigParser::invalidateTextCache(void)
+{
+	QMutexLocker locker(&textCacheMutex);
+	const QList<QString> keys = textCache.keys();
+	for(int i = 0; i < keys.count(); i++)
+	{
+		if(keys[i].startsWith(packId + "|"))
+			textCache.remove(keys[i]);
+	}
+	packRevision++;
+	updatePackId();
+}
+
+/*! Returns text cache key of the exercise. lineLength is -1 for text without line wrapping. */
+QString ConfigParser::textCacheKey(int lesson, int sublesson, int exercise, int lineLength)
+{
+	return packId + "|" + QString::number(lesson) + "." + QString::number(sublesson) + "." + QString::number(exercise) + "|" + QString::number(lineLength);
 }
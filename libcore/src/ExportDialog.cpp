@@ -22,7 +22,7 @@
 #include "ui_ExportDialog.h"
 
 /*! Constructs ExportDialog. */
-ExportDialog::ExportDialog(QString text, QVariantMap result, QList<QVariantMap> mistakes, QWidget *parent) :
+ExportDialog::ExportDialog(QString text, QVariantMap result, MistakeList mistakes, QWidget *parent) :
 	QDialog(parent),
 	ui(new Ui::ExportDialog),
 	inputText(text),
@@ -39,9 +39,9 @@ ExportDialog::ExportDialog(QString text, QVariantMap result, QList<QVariantMap>
 		if(lines[i].count() > longestLineLength)
 			longestLineLength = lines[i].count();
 	}
-	QMap<int, QVariantMap *> mistakesMap;
+	QMap<int, const Mistake *> mistakesMap;
 	for(int i = 0; i < recordedMistakes.count(); i++)
-		mistakesMap[recordedMistakes[i]["pos"].toInt()] = &recordedMistakes[i];
+		mistakesMap[recordedMistakes[i].pos] = &recordedMistakes[i];
 	int pos = 0;
 	for(int i = 0; i < lines.count(); i++)
 	{
@@ -56,8 +56,7 @@ ExportDialog::ExportDialog(QString text, QVariantMap result, QList<QVariantMap>
 				append = "";
 			if(mistakesMap.contains(pos))
 			{
-				QVariantMap *currentMistake = mistakesMap[pos];
-				if(!(currentMistake->contains("disable") && currentMistake->value("disable").toBool()))
+				if(!mistakesMap[pos]->disable)
 					lineMistakes++;
 				if(append == "")
 					append.prepend("&nbsp;");
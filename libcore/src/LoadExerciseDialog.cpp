@@ -59,12 +59,12 @@ void LoadExerciseDialog::init(void)
 	if(Settings::customLessonPack())
 		packPath = packName;
 	else
-		packPath = ":/res/configs/" + packName;
-	ConfigParser parser;
-	if(parser.open(packPath))
+		packPath = BuiltInPacks::packPath(packName);
+	QSharedPointer<ConfigParser> parser = PackRegistry::pack(packPath);
+	if(parser)
 	{
-		m_exerciseText = parser.exerciseText(publicPos::currentLesson, publicPos::currentSublesson, publicPos::currentExercise);
-		m_lineLength = parser.exerciseLineLength(publicPos::currentLesson, publicPos::currentSublesson, publicPos::currentExercise);
+		m_exerciseText = parser->exerciseText(publicPos::currentLesson, publicPos::currentSublesson, publicPos::currentExercise);
+		m_lineLength = parser->exerciseLineLength(publicPos::currentLesson, publicPos::currentSublesson, publicPos::currentExercise);
 		m_includeNewLines = true;
 	}
 	if(local)
@@ -0,0 +1,48 @@
+/*
+ * Mistake.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Mistake.h"
+
+/*!
+ * Returns the mistake as a map with "pos", "type", "previous", "previousPos", "merged" and "disable" keys.\n
+ * The type is "change", "deletion" or "addition". This is used by addon events.
+ */
+QVariantMap Mistake::toVariantMap(void) const
+{
+	QVariantMap out;
+	out["pos"] = pos;
+	switch(type)
+	{
+		case Type_Change:
+			out["type"] = "change";
+			break;
+		case Type_Deletion:
+			out["type"] = "deletion";
+			break;
+		case Type_Addition:
+			out["type"] = "addition";
+			break;
+	}
+	out["previous"] = previous;
+	out["previousPos"] = previousPos;
+	out["merged"] = merged;
+	out["disable"] = disable;
+	return out;
+}
@@ -0,0 +1,149 @@
+/*
+ * PackLoader.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtConcurrent>
+#include "PackLoader.h"
+
+/*! Constructs PackLoader. */
+PackLoader::PackLoader(QObject *parent) :
+	QObject(parent)
+{
+	m_parser = QSharedPointer<ConfigParser>::create();
+}
+
+/*! Destroys the PackLoader object. Loading is cancelled. */
+PackLoader::~PackLoader()
+{
+	cancel();
+	future.waitForFinished();
+}
+
+/*!
+ * Starts loading the pack and returns immediately.\n
+ * A new parser is created (see parser()). If another pack is being loaded, it's cancelled.
+ */
+void PackLoader::load(const QString fileName)
+{
+	cancel();
+	// The previous worker stops after reading the current chunk
+	future.waitForFinished();
+	m_fileName = fileName;
+	m_parser = QSharedPointer<ConfigParser>::create();
+	m_parser->loadToBuffer("");
+	reportedLessons = 0;
+	loading = true;
+	timer.start();
+	int loadGeneration = generation.fetchAndAddOrdered(1) + 1;
+	future = QtConcurrent::run([this, fileName, loadGeneration]() {
+		readFile(fileName, loadGeneration);
+	});
+}
+
+/*! Cancels loading. The lessons which were already loaded remain in parser(). */
+void PackLoader::cancel(void)
+{
+	// Chunks of the old pack are ignored (see addChunk())
+	generation.fetchAndAddOrdered(1);
+	loading = false;
+}
+
+/*! Returns true if a pack is being loaded. */
+bool PackLoader::isLoading(void)
+{
+	return loading;
+}
+
+/*! Returns the file name of the loaded pack. */
+QString PackLoader::fileName(void)
+{
+	return m_fileName;
+}
+
+/*! Returns the parser with the loaded part of the pack. */
+QSharedPointer<ConfigParser> PackLoader::parser(void)
+{
+	return m_parser;
+}
+
+/*! Reads the pack file in chunks. This runs in a worker thread. */
+void PackLoader::readFile(const QString fileName, int loadGeneration)
+{
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly))
+	{
+		QMetaObject::invokeMethod(this, "finishLoading", Qt::QueuedConnection, Q_ARG(int, loadGeneration), Q_ARG(bool, false));
+		return;
+	}
+	QByteArray pending;
+	while(!file.atEnd())
+	{
+		if(generation.loadAcquire() != loadGeneration)
+			return;
+		pending += file.read(chunkSize);
+		// Send only whole lines
+		int end = pending.lastIndexOf('\n');
+		if(end == -1)
+			continue;
+		QMetaObject::invokeMethod(this, "addChunk", Qt::QueuedConnection, Q_ARG(QByteArray, pending.left(end + 1)), Q_ARG(int, loadGeneration));
+		pending.remove(0, end + 1);
+	}
+	if(!pending.isEmpty())
+		QMetaObject::invokeMethod(this, "addChunk", Qt::QueuedConnection, Q_ARG(QByteArray, pending), Q_ARG(int, loadGeneration));
+	QMetaObject::invokeMethod(this, "finishLoading", Qt::QueuedConnection, Q_ARG(int, loadGeneration), Q_ARG(bool, true));
+}
+
+/*! Emits lessonsDiscovered() for lessons which weren't reported yet. */
+void PackLoader::reportLessons(int lastLesson)
+{
+	if(lastLesson <= reportedLessons)
+		return;
+	int first = reportedLessons + 1;
+	reportedLessons = lastLesson;
+	emit lessonsDiscovered(first, lastLesson);
+}
+
+/*! Adds a chunk read by readFile() to the parser. */
+void PackLoader::addChunk(const QByteArray chunk, int loadGeneration)
+{
+	if(generation.loadAcquire() != loadGeneration)
+		return;
+	m_parser->appendToBuffer(chunk);
+	// The last lesson may continue in the next chunk
+	reportLessons(m_parser->lessonCount() - 1);
+}
+
+/*! Called by readFile() when the whole file is read. */
+void PackLoader::finishLoading(int loadGeneration, bool success)
+{
+	if(generation.loadAcquire() != loadGeneration)
+		return;
+	loading = false;
+	if(success)
+	{
+		reportLessons(m_parser->lessonCount());
+		qInfo("Loaded pack %s (%d lessons) in %.2f ms", qPrintable(m_fileName), m_parser->lessonCount(), timer.nsecsElapsed() / 1000000.0);
+		emit finished();
+	}
+	else
+	{
+		qWarning("Failed to open pack %s", qPrintable(m_fileName));
+		emit failed();
+	}
+}
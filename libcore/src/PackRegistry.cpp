@@ -0,0 +1,187 @@
+/*
+ * PackRegistry.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include "PackRegistry.h"
+#include "BuiltInPacks.h"
+#include "Settings.h"
+
+QMutex PackRegistry::mutex;
+QMap<QString, PackRegistry::Entry> PackRegistry::packs;
+
+/*!
+ * Starts indexing the packs in the global thread pool and returns immediately.\n
+ * Packs which are already in the registry are skipped.
+ */
+void PackRegistry::preload(const QStringList paths)
+{
+	QMutexLocker locker(&mutex);
+	for(int i = 0; i < paths.count(); i++)
+	{
+		if((paths[i] == "") || packs.contains(paths[i]))
+			continue;
+		Entry entry;
+		entry.fileId = fileId(paths[i]);
+		entry.future = QtConcurrent::run(&PackRegistry::indexPack, paths[i]);
+		packs.insert(paths[i], entry);
+	}
+}
+
+/*! Starts indexing all built-in packs and recently opened custom packs. \see preload() */
+void PackRegistry::preloadAll(void)
+{
+	preload(builtInPacks() + Settings::recentPacks());
+}
+
+/*!
+ * Returns the indexed pack, or a null pointer if it can't be opened.\n
+ * If the pack is being indexed in the background, this function waits until it's done.
+ * If the pack isn't in the registry (or the custom pack file has changed), it's indexed in the calling thread.
+ */
+QSharedPointer<ConfigParser> PackRegistry::pack(const QString path)
+{
+	if(path == "")
+		return QSharedPointer<ConfigParser>();
+	QString id = fileId(path);
+	QFuture<QSharedPointer<ConfigParser>> future;
+	bool pending = false;
+	{
+		QMutexLocker locker(&mutex);
+		auto target = packs.find(path);
+		if(target != packs.end())
+		{
+			if(target->fileId == id)
+			{
+				if(target->parser)
+					return target->parser;
+				future = target->future;
+				pending = true;
+			}
+			else
+				packs.erase(target);
+		}
+	}
+	QSharedPointer<ConfigParser> parser = pending ? future.result() : indexPack(path);
+	QMutexLocker locker(&mutex);
+	if(parser)
+	{
+		Entry entry;
+		entry.parser = parser;
+		entry.fileId = id;
+		packs.insert(path, entry);
+	}
+	else
+		packs.remove(path);
+	return parser;
+}
+
+/*!
+ * Adds a pack, which was loaded in another way (for example by PackLoader), to the registry.\n
+ * The parser must not be modified after that.
+ */
+void PackRegistry::insert(const QString path, QSharedPointer<ConfigParser> parser)
+{
+	Entry entry;
+	entry.parser = parser;
+	entry.fileId = fileId(path);
+	QMutexLocker locker(&mutex);
+	packs.insert(path, entry);
+}
+
+/*! Removes the pack from the registry. Handles returned by pack() remain valid. */
+void PackRegistry::remove(const QString path)
+{
+	QMutexLocker locker(&mutex);
+	packs.remove(path);
+}
+
+/*! Adds a custom pack to the list of recently opened packs. \see Settings#recentPacks() */
+void PackRegistry::addRecentPack(const QString path)
+{
+	QStringList recentPacks = Settings::recentPacks();
+	recentPacks.removeAll(path);
+	recentPacks.prepend(path);
+	while(recentPacks.count() > recentPackLimit)
+		recentPacks.removeLast();
+	Settings::setRecentPacks(recentPacks);
+}
+
+/*! Returns paths of all built-in packs. \see BuiltInPacks#packPath() */
+QStringList PackRegistry::builtInPacks(void)
+{
+	QStringList out;
+	const QStringList names = QDir(":/res/configs").entryList(QDir::Files);
+	for(int i = 0; i < names.count(); i++)
+		out += BuiltInPacks::packPath(names[i]);
+	return out;
+}
+
+/*! Opens and indexes the pack. The time it takes is written to the log. */
+QSharedPointer<ConfigParser> PackRegistry::indexPack(const QString path)
+{
+	QElapsedTimer timer;
+	timer.start();
+	QSharedPointer<ConfigParser> parser(new ConfigParser);
+	bool ret;
+	if(isCustomPack(path))
+	{
+		// Don't keep the file open, so that it can be modified
+		QFile file(path);
+		ret = file.open(QIODevice::ReadOnly | QIODevice::Text);
+		if(ret)
+			parser->loadToBuffer(file.readAll());
+	}
+	else
+		ret = parser->open(path);
+	if(!ret)
+	{
+		qWarning("Failed to open pack %s", qPrintable(path));
+		return QSharedPointer<ConfigParser>();
+	}
+	// The parser is used by the main thread
+	if(QCoreApplication::instance())
+		parser->moveToThread(QCoreApplication::instance()->thread());
+	qInfo("Indexed pack %s (%d lessons) in %.2f ms", qPrintable(path), parser->lessonCount(), timer.nsecsElapsed() / 1000000.0);
+	return parser;
+}
+
+/*! Returns true if the pack isn't a built-in pack. */
+bool PackRegistry::isCustomPack(const QString path)
+{
+	return !path.startsWith(':');
+}
+
+/*!
+ * Returns an ID, which changes when the custom pack file changes. Built-in packs don't change.\n
+ * Only the size and the modification time are compared, so a change with the same size within
+ * the timestamp resolution isn't detected. Use remove() after writing the file.
+ */
+QString PackRegistry::fileId(const QString path)
+{
+	if(!isCustomPack(path))
+		return QString();
+	QFileInfo fileInfo(path);
+	return QString::number(fileInfo.size()) + ":" + QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
+}
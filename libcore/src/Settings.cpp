@@ -19,6 +19,7 @@
  */
 
 #include "Settings.h"
+#include "ValidationSettings.h"
 
 QSettings *Settings::settingsInstance = nullptr;
 #ifdef Q_OS_WASM
@@ -185,35 +186,35 @@ void Settings::setCustomLessonPack(bool value) { set("main/customconfig", value)
 // errorPenalty
 
 /*! Getter for main/errorpenalty. */
-int Settings::errorPenalty(void) { return get("main/errorpenalty", 10).toInt(); }
+int Settings::errorPenalty(void) { return get(ValidationSettings::errorPenaltyKey, ValidationSettings::defaultErrorPenalty).toInt(); }
 
 /*! Returns true if there's a main/errorpenalty key. */
-bool Settings::containsErrorPenalty(void) { return contains("main/errorpenalty"); }
+bool Settings::containsErrorPenalty(void) { return contains(ValidationSettings::errorPenaltyKey); }
 
 /*! Setter for main/errorpenalty. */
-void Settings::setErrorPenalty(int value) { set("main/errorpenalty", value); }
+void Settings::setErrorPenalty(int value) { set(ValidationSettings::errorPenaltyKey, value); }
 
 // mistakeLimit
 
 /*! Getter for main/mistakelimit. */
-bool Settings::mistakeLimit(void) { return get("main/mistakelimit", true).toBool(); }
+bool Settings::mistakeLimit(void) { return get(ValidationSettings::mistakeLimitKey, ValidationSettings::defaultMistakeLimit).toBool(); }
 
 /*! Returns true if there's a main/mistakelimit key. */
-bool Settings::containsMistakeLimit(void) { return contains("main/mistakelimit"); }
+bool Settings::containsMistakeLimit(void) { return contains(ValidationSettings::mistakeLimitKey); }
 
 /*! Setter for main/mistakelimit. */
-void Settings::setMistakeLimit(bool value) { set("main/mistakelimit", value); }
+void Settings::setMistakeLimit(bool value) { set(ValidationSettings::mistakeLimitKey, value); }
 
 // mistakeChars
 
 /*! Getter for main/mistakechars. */
-int Settings::mistakeChars(void) { return get("main/mistakechars", 6).toInt(); }
+int Settings::mistakeChars(void) { return get(ValidationSettings::mistakeCharsKey, ValidationSettings::defaultMistakeChars).toInt(); }
 
 /*! Returns true if there's a main/mistakechars key. */
-bool Settings::containsMistakeChars(void) { return contains("main/mistakechars"); }
+bool Settings::containsMistakeChars(void) { return contains(ValidationSettings::mistakeCharsKey); }
 
 /*! Setter for main/mistakechars. */
-void Settings::setMistakeChars(int value) { set("main/mistakechars", value); }
+void Settings::setMistakeChars(int value) { set(ValidationSettings::mistakeCharsKey, value); }
 
 // themeFont
 
@@ -542,3 +543,14 @@ bool Settings::containsKeyboardVisible(void) { return contains("view/keyboardvis
 
 /*! Setter for view/keyboardvisible. */
 void Settings::setKeyboardVisible(bool value) { set("view/keyboardvisible", value); }
+
+// recentPacks
+
+/*! Getter for main/recentpacks. */
+QStringList Settings::recentPacks(void) { return get("main/recentpacks", QStringList()).toStringList(); }
+
+/*! Returns true if there's a main/recentpacks key. */
+bool Settings::containsRecentPacks(void) { return contains("main/recentpacks"); }
+
+/*! Setter for main/recentpacks. */
+void Settings::setRecentPacks(QStringList value) { set("main/recentpacks", value); }
@@ -18,7 +18,14 @@
  * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+#include <algorithm>
+#include <QHash>
+#include <QtAlgorithms>
+#include <QtConcurrent>
 #include "StringUtils.h"
+#include "Settings.h"
+#include "TokenTable.h"
 
 /*! Returns number of words in the string. */
 int StringUtils::wordCount(QString str)
@@ -78,92 +85,410 @@ QString StringUtils::wordAt(QString str, int index)
 	return "";
 }
 
-/*! Returns the length of the longest common subsequence of source and target list. */
-int StringUtils::lcsLen(QList<QVariant> source, QList<QVariant> target)
+/*!
+ * Replaces items of both lists with integer IDs, so that they can be compared faster.\n
+ * Items which are equal get the same ID.
+ */
+void StringUtils::lcsSymbols(const QList<QVariant> &source, const QList<QVariant> &target, QVector<int> *sourceIds, QVector<int> *targetIds)
 {
-	QMap<int, QMap<int, int>> table;
-	return lcsLen(source, target, &table);
+	const QList<QVariant> *lists[2] = { &source, &target };
+	QVector<int> *ids[2] = { sourceIds, targetIds };
+	bool strings = true;
+	for(int i = 0; (i < 2) && strings; i++)
+	{
+		for(int j = 0; j < lists[i]->count(); j++)
+		{
+			if(lists[i]->at(j).userType() != QMetaType::QString)
+			{
+				strings = false;
+				break;
+			}
+		}
+	}
+	QHash<QString, int> stringIds;
+	QList<QVariant> symbols;
+	for(int i = 0; i < 2; i++)
+	{
+		ids[i]->resize(lists[i]->count());
+		for(int j = 0; j < lists[i]->count(); j++)
+		{
+			const QVariant &item = lists[i]->at(j);
+			int id;
+			if(strings)
+			{
+				const QString str = item.toString();
+				auto found = stringIds.constFind(str);
+				if(found == stringIds.constEnd())
+				{
+					id = stringIds.count();
+					stringIds.insert(str, id);
+				}
+				else
+					id = found.value();
+			}
+			else
+			{
+				id = symbols.indexOf(item);
+				if(id == -1)
+				{
+					id = symbols.count();
+					symbols += item;
+				}
+			}
+			(*ids[i])[j] = id;
+		}
+	}
 }
 
-int StringUtils::lcsLen(QList<QVariant> source, QList<QVariant> target, QMap<int, QMap<int, int>> *lcsTable)
+/*! Computes a row of the LCS table from the previous row. */
+static inline void lcsRow(const int *previous, int *current, int sourceItem, const int *target, int targetCount)
+{
+	current[0] = 0;
+	for(int j = 1; j <= targetCount; j++)
+	{
+		if(sourceItem == target[j - 1])
+			current[j] = previous[j - 1] + 1;
+		else
+			current[j] = std::max(previous[j], current[j - 1]);
+	}
+}
+
+/*! Returns the length of the longest common subsequence. Only 2 rows of the LCS table are stored. */
+int StringUtils::lcsLen(const QVector<int> &source, const QVector<int> &target)
+{
+	const int width = target.count() + 1;
+	QVector<int> previous(width, 0), current(width, 0);
+	for(int i = 1; i <= source.count(); i++)
+	{
+		lcsRow(previous.constData(), current.data(), source[i - 1], target.constData(), target.count());
+		previous.swap(current);
+	}
+	return previous[target.count()];
+}
+
+/*!
+ * Returns indices of source items, which belong to the longest common subsequence.\n
+ * The LCS table is stored in a flat row-major buffer.
+ * If it's larger than lcsTableLimit, only every k-th row (checkpoint) is stored
+ * and the rows between checkpoints are computed again during the traceback, so the memory usage is O(sqrt(n) * m).\n
+ * The traceback is the same in both cases, so the result doesn't depend on the size of the input.
+ */
+QVector<int> StringUtils::lcsIndices(const QVector<int> &source, const QVector<int> &target)
 {
 	/*
 	* References:
 	* https://www.geeksforgeeks.org/printing-longest-common-subsequence/
 	* https://nasauber.de/blog/2019/levenshtein-distance-and-longest-common-subsequence-in-qt/
 	*/
-	QMap<int, QMap<int, int>> l;
-	for(int i = 0; i <= source.count(); i++)
+	QVector<int> out;
+	const int n = source.count(), m = target.count();
+	if((n == 0) || (m == 0))
+		return out;
+	const int width = m + 1;
+	int blockSize = n;
+	if(qint64(n + 1) * width > lcsTableLimit)
+		blockSize = std::max(1, int(std::sqrt(double(n))));
+	// Store the checkpoints (rows 0, k, 2k, ...) before the last block
+	const int lastCheckpoint = ((n - 1) / blockSize) * blockSize;
+	QVector<int> checkpoints((lastCheckpoint / blockSize + 1) * width, 0);
+	QVector<int> previous(width, 0), current(width, 0);
+	for(int i = 1; i <= lastCheckpoint; i++)
+	{
+		lcsRow(previous.constData(), current.data(), source[i - 1], target.constData(), m);
+		previous.swap(current);
+		if(i % blockSize == 0)
+			std::copy(previous.constBegin(), previous.constEnd(), checkpoints.begin() + (i / blockSize) * width);
+	}
+	previous.clear();
+	current.clear();
+	// Traceback, block by block from the end
+	QVector<int> block((std::min(blockSize, n) + 1) * width);
+	int i = n, j = m;
+	for(int checkpoint = lastCheckpoint; (checkpoint >= 0) && (i > 0) && (j > 0); checkpoint -= blockSize)
 	{
-		for(int j = 0; j <= target.count(); j++)
+		// Compute rows checkpoint - i
+		int *data = block.data();
+		std::copy(checkpoints.constBegin() + (checkpoint / blockSize) * width, checkpoints.constBegin() + (checkpoint / blockSize + 1) * width, data);
+		for(int row = checkpoint + 1; row <= i; row++)
+			lcsRow(data + (row - checkpoint - 1) * width, data + (row - checkpoint) * width, source[row - 1], target.constData(), m);
+		while((i > checkpoint) && (j > 0))
 		{
-			if(i == 0 || j == 0)
-				l[i][j] = 0;
-			else if(source.at(i - 1) == target.at(j - 1))
-				l[i][j] = l[i - 1][j - 1] + 1;
+			if(source[i - 1] == target[j - 1])
+			{
+				out.append(i - 1);
+				i--;
+				j--;
+			}
+			// This method works better for switched characters (e. g. abcd -> acbd)
+			else if(data[(i - 1 - checkpoint) * width + j] > data[(i - checkpoint) * width + j - 1])
+				i--;
 			else
-				l[i][j] = std::max(l[i - 1][j], l[i][j - 1]);
+				j--;
 		}
 	}
-	*lcsTable = l;
-	return l[source.count()][target.count()];
+	std::reverse(out.begin(), out.end());
+	return out;
 }
 
-/*! Returns the longest common subsequence of source and target list. */
-QList<QVariant> StringUtils::longestCommonSubsequence(QList<QVariant> source, QList<QVariant> target)
+/*! Computes a row of the bit-parallel LCS table from the previous row. \see StringUtils#lcsIndices() */
+static inline void lcsBitRow(const quint64 *previous, quint64 *current, const quint64 *match, int words)
 {
-	QMap<int, QMap<int, int>> l;
-	lcsLen(source, target, &l);
-	int i = source.count();
-	int j = target.count();
-	QList<QVariant> longestCommonSubsequence;
-	while(i > 0 && j > 0)
+	// V' = (V + (V & M)) | (V - (V & M)), the carry is propagated through all words
+	quint64 carry = 0;
+	for(int k = 0; k < words; k++)
 	{
-		if(i == 0)
-			j--;
-		else if(j == 0)
-			i--;
-		else if(source.at(i - 1) == target.at(j - 1))
+		quint64 v = previous[k];
+		quint64 u = v & match[k];
+		quint64 sum = v + carry;
+		quint64 nextCarry = (sum < carry);
+		sum += u;
+		nextCarry |= (sum < u);
+		current[k] = sum | (v - u);
+		carry = nextCarry;
+	}
+}
+
+/*! Returns the LCS length of a prefix of the target (with the given length) from a row of the bit-parallel LCS table. */
+static inline int lcsBitValue(const quint64 *row, int column)
+{
+	// Zero bits are the columns where the LCS length increases
+	int out = column;
+	int k;
+	for(k = 0; k < column / 64; k++)
+		out -= qPopulationCount(row[k]);
+	if(column % 64)
+		out -= qPopulationCount(row[k] & ((quint64(1) << (column % 64)) - 1));
+	return out;
+}
+
+/*!
+ * Returns indices of source characters, which belong to the longest common subsequence.\n
+ * This is a bit-parallel version of lcsIndices(const QVector<int> &, const QVector<int> &) for UTF-16 code units (Hyyrö's algorithm).
+ * Every row of the LCS table is stored as a bit vector (64 columns per word), where a zero bit means that the LCS length increases in the column.
+ * Rows are stored in the same way as in the other version (with checkpoints for long strings)
+ * and the traceback computes the LCS lengths from the bit vectors, so the result is the same.
+ */
+QVector<int> StringUtils::lcsIndices(const QString &source, const QString &target)
+{
+	QVector<int> out;
+	const int n = source.count(), m = target.count();
+	if((n == 0) || (m == 0))
+		return out;
+	const int words = (m + 63) / 64;
+	// Match masks (positions of each character in the target)
+	QHash<ushort, QVector<quint64>> masks;
+	for(int j = 0; j < m; j++)
+	{
+		QVector<quint64> &mask = masks[target[j].unicode()];
+		if(mask.isEmpty())
+			mask.fill(0, words);
+		mask[j / 64] |= quint64(1) << (j % 64);
+	}
+	const QVector<quint64> noMatch(words, 0);
+	QVector<const quint64 *> rowMasks(n);
+	for(int i = 0; i < n; i++)
+	{
+		auto mask = masks.constFind(source[i].unicode());
+		rowMasks[i] = (mask == masks.constEnd()) ? noMatch.constData() : mask->constData();
+	}
+	int blockSize = n;
+	if(qint64(n + 1) * words > lcsTableLimit)
+		blockSize = std::max(1, int(std::sqrt(double(n))));
+	// Store the checkpoints (rows 0, k, 2k, ...) before the last block
+	const int lastCheckpoint = ((n - 1) / blockSize) * blockSize;
+	QVector<quint64> checkpoints((lastCheckpoint / blockSize + 1) * words, ~quint64(0));
+	QVector<quint64> previous(words, ~quint64(0)), current(words);
+	for(int i = 1; i <= lastCheckpoint; i++)
+	{
+		lcsBitRow(previous.constData(), current.data(), rowMasks[i - 1], words);
+		previous.swap(current);
+		if(i % blockSize == 0)
+			std::copy(previous.constBegin(), previous.constEnd(), checkpoints.begin() + (i / blockSize) * words);
+	}
+	previous.clear();
+	current.clear();
+	// Traceback, block by block from the end
+	QVector<quint64> block((std::min(blockSize, n) + 1) * words);
+	int i = n, j = m;
+	for(int checkpoint = lastCheckpoint; (checkpoint >= 0) && (i > 0) && (j > 0); checkpoint -= blockSize)
+	{
+		// Compute rows checkpoint - i
+		quint64 *data = block.data();
+		std::copy(checkpoints.constBegin() + (checkpoint / blockSize) * words, checkpoints.constBegin() + (checkpoint / blockSize + 1) * words, data);
+		for(int row = checkpoint + 1; row <= i; row++)
+			lcsBitRow(data + (row - checkpoint - 1) * words, data + (row - checkpoint) * words, rowMasks[row - 1], words);
+		while((i > checkpoint) && (j > 0))
+		{
+			if(source[i - 1] == target[j - 1])
+			{
+				out.append(i - 1);
+				i--;
+				j--;
+			}
+			// The same tie-breaking rule as in the other version
+			else if(lcsBitValue(data + (i - 1 - checkpoint) * words, j) > lcsBitValue(data + (i - checkpoint) * words, j - 1))
+				i--;
+			else
+				j--;
+		}
+	}
+	std::reverse(out.begin(), out.end());
+	return out;
+}
+
+/*!
+ * Returns the same indices as lcsIndices(), but it uses the Myers O(ND) algorithm,
+ * which is faster if there are only a few differences (D) between the lists.\n
+ * The furthest reaching points of every D-path are stored. Because the edit distance of prefixes doesn't decrease along a diagonal,
+ * they can be used to get the distance of any prefix, so the traceback chooses the same path as the traceback of the LCS table.\n
+ * If the stored points would use more memory than lcsTableLimit, lcsIndices() is used.
+ */
+QVector<int> StringUtils::lcsIndicesMyers(const QVector<int> &source, const QVector<int> &target)
+{
+	/*
+	* Reference:
+	* E. W. Myers: An O(ND) difference algorithm and its variations (1986)
+	*/
+	QVector<int> out;
+	const int n = source.count(), m = target.count();
+	if((n == 0) || (m == 0))
+		return out;
+	// x of the furthest reaching point on diagonal k = x - y (-1 if it can't be reached)
+	const int offset = m + 1;
+	QVector<int> v(n + m + 3, -1);
+	// Points of every D-path (k = -d, -d + 2, ..., d)
+	QVector<int> trace;
+	int d;
+	for(d = 0; ; d++)
+	{
+		if(qint64(trace.count()) + d + 1 > lcsTableLimit)
+			return lcsIndices(source, target);
+		bool done = false;
+		for(int k = -d; k <= d; k += 2)
+		{
+			int x = -1;
+			if((k >= -m) && (k <= n))
+			{
+				if(d == 0)
+					x = 0;
+				else
+				{
+					// Skip a target item
+					int down = v[k + 1 + offset];
+					if((down != -1) && (down - k <= m))
+						x = down;
+					// Skip a source item
+					int right = v[k - 1 + offset];
+					if((right != -1) && (right + 1 <= n) && (right + 1 > x))
+						x = right + 1;
+				}
+				if(x != -1)
+				{
+					int y = x - k;
+					while((x < n) && (y < m) && (source[x] == target[y]))
+					{
+						x++;
+						y++;
+					}
+					if((x == n) && (y == m))
+						done = true;
+				}
+				v[k + offset] = x;
+			}
+			trace.append(x);
+		}
+		if(done)
+			break;
+	}
+	// Traceback from the end (see lcsIndices())
+	auto furthest = [&trace](int distance, int k) {
+		if((distance < 0) || (k < -distance) || (k > distance))
+			return -1;
+		return trace[distance * (distance + 1) / 2 + (k + distance) / 2];
+	};
+	int i = n, j = m;
+	while((i > 0) && (j > 0))
+	{
+		if(source[i - 1] == target[j - 1])
 		{
-			longestCommonSubsequence.prepend(source.at(i - 1));
+			out.append(i - 1);
 			i--;
 			j--;
 		}
-		//else if (l[i][j] == l[i-1][j])
-		else if(l[i - 1][j] > l[i][j - 1]) // This method works better for switched characters (e. g. abcd -> acbd)
-			i--;
-		else
+		// If the distance of (i, j - 1) is d - 1, the LCS table has the same value there
+		else if(furthest(d - 1, i - j + 1) >= i)
+		{
 			j--;
+			d--;
+		}
+		else
+		{
+			i--;
+			d--;
+		}
 	}
+	std::reverse(out.begin(), out.end());
+	return out;
+}
+
+/*! Returns the length of the longest common subsequence of source and target list. */
+int StringUtils::lcsLen(QList<QVariant> source, QList<QVariant> target)
+{
+	QVector<int> sourceIds, targetIds;
+	lcsSymbols(source, target, &sourceIds, &targetIds);
+	return lcsLen(sourceIds, targetIds);
+}
+
+/*! Returns the longest common subsequence of source and target list. */
+QList<QVariant> StringUtils::longestCommonSubsequence(QList<QVariant> source, QList<QVariant> target)
+{
+	QVector<int> sourceIds, targetIds;
+	lcsSymbols(source, target, &sourceIds, &targetIds);
+	const QVector<int> indices = lcsIndicesMyers(sourceIds, targetIds);
+	QList<QVariant> longestCommonSubsequence;
+	longestCommonSubsequence.reserve(indices.count());
+	for(int i = 0; i < indices.count(); i++)
+		longestCommonSubsequence += source.at(indices[i]);
 	return longestCommonSubsequence;
 }
 
 /*! Returns the longest common subsequence of source and target string. */
 QString StringUtils::longestCommonSubsequence(QString source, QString target)
 {
-	QList<QVariant> sourceList, targetList;
-	int i;
-	for(i = 0; i < source.count(); i++)
-		sourceList += QString(source[i]);
-	for(i = 0; i < target.count(); i++)
-		targetList += QString(target[i]);
-	QList<QVariant> lcs = longestCommonSubsequence(sourceList, targetList);
-	QString out = "";
-	for(i = 0; i < lcs.count(); i++)
-		out += lcs[i].toString();
+	const QVector<int> indices = lcsIndices(source, target);
+	QString out;
+	out.reserve(indices.count());
+	for(int i = 0; i < indices.count(); i++)
+		out += source[indices[i]];
 	return out;
 }
 
-/*! Compares 2 lists using longest common subsequence. */
-QList<QVariantMap> StringUtils::compareLists(QList<QVariant> source, QList<QVariant> target, QVector<QPair<QString, int>> *recordedCharacters, int *hits, int *inputPos)
+/*! Returns the item stored in Mistake#previous. */
+static inline QString diffItem(const QVariant &item)
+{
+	return item.toString();
+}
+
+/*! Returns the character stored in Mistake#previous (as a string). */
+static inline QString diffItem(QChar item)
 {
-	QList<QVariantMap> out;
-	auto lcs = longestCommonSubsequence(source, target);
+	return QString(item);
+}
+
+/*!
+ * Compares 2 sequences (lists or strings) using their longest common subsequence.
+ * \see StringUtils#compareLists()
+ * \see StringUtils#compareStrings()
+ */
+template<typename Sequence, typename Item>
+static MistakeList compareSequences(const Sequence &source, const Sequence &target, const Sequence &lcs, QVector<QPair<QString, int>> *recordedCharacters, int *hits, int *inputPos)
+{
+	MistakeList out;
 	int sourcePos = 0, targetPos = 0;
 	int count = std::max(source.count(), target.count());
 	for(int i = 0; i < count; i++)
 	{
-		QVariant subseq, sourceSubseq, targetSubseq;
+		Item subseq, sourceSubseq, targetSubseq;
 		bool lcsSrc = false, lcsTarget = false;
 		if(i < lcs.count())
 		{
@@ -204,11 +529,11 @@ QList<QVariantMap> StringUtils::compareLists(QList<QVariant> source, QList<QVari
 		if(!lcsSrc && !lcsTarget)
 		{
 			// Changed character
-			QVariantMap diff;
-			diff["pos"] = targetPos;
-			diff["type"] = "change";
-			diff["previous"] = sourceSubseq;
-			diff["previousPos"] = sourcePos;
+			Mistake diff;
+			diff.pos = targetPos;
+			diff.type = Mistake::Type_Change;
+			diff.previous = diffItem(sourceSubseq);
+			diff.previousPos = sourcePos;
 			out += diff;
 			targetPos++;
 			if(inputPos)
@@ -219,11 +544,11 @@ QList<QVariantMap> StringUtils::compareLists(QList<QVariant> source, QList<QVari
 		else if(!lcsSrc)
 		{
 			// Deleted character
-			QVariantMap diff;
-			diff["pos"] = targetPos;
-			diff["type"] = "deletion";
-			diff["previous"] = sourceSubseq;
-			diff["previousPos"] = sourcePos;
+			Mistake diff;
+			diff.pos = targetPos;
+			diff.type = Mistake::Type_Deletion;
+			diff.previous = diffItem(sourceSubseq);
+			diff.previousPos = sourcePos;
 			out += diff;
 			sourcePos++;
 			if(inputPos)
@@ -233,9 +558,9 @@ QList<QVariantMap> StringUtils::compareLists(QList<QVariant> source, QList<QVari
 		else if(!lcsTarget)
 		{
 			// Added character
-			QVariantMap diff;
-			diff["pos"] = targetPos;
-			diff["type"] = "addition";
+			Mistake diff;
+			diff.pos = targetPos;
+			diff.type = Mistake::Type_Addition;
 			out += diff;
 			targetPos++;
 			if(inputPos)
@@ -256,138 +581,115 @@ QList<QVariantMap> StringUtils::compareLists(QList<QVariant> source, QList<QVari
 	return out;
 }
 
-/*! Compares 2 strings using longest common subsequence. */
-QList<QVariantMap> StringUtils::compareStrings(QString source, QString target, QVector<QPair<QString, int>> *recordedCharacters, int *hits, int *inputPos)
+/*! Compares 2 lists using longest common subsequence. */
+MistakeList StringUtils::compareLists(QList<QVariant> source, QList<QVariant> target, QVector<QPair<QString, int>> *recordedCharacters, int *hits, int *inputPos)
 {
-	QList<QVariant> sourceList, targetList;
-	int i;
-	for(i = 0; i < source.count(); i++)
-		sourceList += QString(source[i]);
-	for(i = 0; i < target.count(); i++)
-		targetList += QString(target[i]);
-	return compareLists(sourceList, targetList, recordedCharacters, hits, inputPos);
+	return compareSequences<QList<QVariant>, QVariant>(source, target, longestCommonSubsequence(source, target), recordedCharacters, hits, inputPos);
 }
 
-/*! Splits each word by punctuation marks. */
-QStringList StringUtils::splitWordsByPunct(QStringList source)
+/*!
+ * Compares 2 strings using longest common subsequence.\n
+ * This is the same as comparing lists of characters using compareLists(), but it uses the bit-parallel LCS algorithm.
+ */
+MistakeList StringUtils::compareStrings(QString source, QString target, QVector<QPair<QString, int>> *recordedCharacters, int *hits, int *inputPos)
 {
-	QStringList out;
-	for(int i = 0; i < source.count(); i++)
-	{
-		QString part = "";
-		bool ignore = (source[i].count() > 0);
-		for(int j = 0; j < source[i].count(); j++)
-		{
-			if(source[i][j].isPunct())
-			{
-				if(!ignore)
-					out += part;
-				ignore = true;
-				part = "";
-				if(j == 0)
-					out += " ";
-				out += QString(source[i][j]);
-				if(j + 1 == source[i].count())
-					out += " ";
-			}
-			else
-			{
-				part += source[i][j];
-				ignore = false;
-			}
-		}
-		if(ignore)
-			ignore = false;
-		else
-			out += part;
-	}
-	return out;
+	return compareSequences<QString, QChar>(source, target, longestCommonSubsequence(source, target), recordedCharacters, hits, inputPos);
 }
 
-/*! Recursively generates a diff list from source and target word list. */
-QMap<int, QVariantMap> StringUtils::generateDiffList(QStringList *sourceWords, QStringList *targetWords, QList<int> *mergeList)
+/*!
+ * Generates a diff list from source and target word list.\n
+ * If a changed word is followed by a deleted or changed word, there might be a "deleted space" between them.
+ * In that case the 2 source words are merged and the lists are compared again.
+ */
+QMap<int, Mistake> StringUtils::generateDiffList(QStringList *sourceWords, QStringList *targetWords)
 {
-	// Compare word lists
 	QList<QVariant> sourceList, targetList;
 	for(int i = 0; i < sourceWords->count(); i++)
 		sourceList += sourceWords->at(i);
 	for(int i = 0; i < targetWords->count(); i++)
 		targetList += targetWords->at(i);
-	QList<QVariantMap> wordDiff = compareLists(sourceList, targetList);
-	QMap<int, QVariantMap> differences;
-	QList<int> newMergeList;
-	if(mergeList == nullptr || !mergeList)
-		mergeList = &newMergeList;
-	for(int i = 0; i < wordDiff.count(); i++)
+	QMap<int, Mistake> differences;
+	QList<int> mergeList;
+	bool merged;
+	do
 	{
-		if(mergeList->contains(wordDiff[i]["pos"].toInt()))
-			wordDiff[i]["merged"] = true;
-		// If current diff is a change and the next one is a deletion or a change,
-		// there might be a "deleted space" between the 2 words.
-		if((i < wordDiff.count() - 1) && (wordDiff[i + 1]["pos"].toInt() == wordDiff[i]["pos"].toInt() + 1) && !mergeList->contains(wordDiff[i]["pos"].toInt()))
+		merged = false;
+		differences.clear();
+		// Compare word lists
+		MistakeList wordDiff = compareLists(sourceList, targetList);
+		for(int i = 0; i < wordDiff.count(); i++)
 		{
-			QVariantMap *currentDiff = &wordDiff[i];
-			QVariantMap *nextDiff = &wordDiff[i + 1];
-			QString type1 = currentDiff->value("type").toString();
-			QString type2 = nextDiff->value("type").toString();
-			QString newWord = currentDiff->value("previous").toString() + " " + nextDiff->value("previous").toString();
-			int count1 = compareStrings(newWord, targetWords->at(currentDiff->value("pos").toInt())).count();
-			int count2 = compareStrings(currentDiff->value("previous").toString(), targetWords->at(currentDiff->value("pos").toInt())).count();
-			if((type1 == "change") && ((type2 == "deletion") || ((type2 == "change") && (count1 < count2))))
+			if(mergeList.contains(wordDiff[i].pos))
+				wordDiff[i].merged = true;
+			// If current diff is a change and the next one is a deletion or a change,
+			// there might be a "deleted space" between the 2 words.
+			if((i < wordDiff.count() - 1) && (wordDiff[i + 1].pos == wordDiff[i].pos + 1) && !mergeList.contains(wordDiff[i].pos))
 			{
-				// old_word1[space]old_word2
-				currentDiff->insert("previous", newWord);
-				currentDiff->insert("merged", true);
-				sourceWords->replace(currentDiff->value("previousPos").toInt(), newWord);
-				sourceWords->removeAt(currentDiff->value("previousPos").toInt() + 1);
-				mergeList->append(currentDiff->value("pos").toInt());
-				return generateDiffList(sourceWords, targetWords, mergeList);
+				Mistake *currentDiff = &wordDiff[i];
+				Mistake *nextDiff = &wordDiff[i + 1];
+				QString newWord = currentDiff->previous + " " + nextDiff->previous;
+				bool merge = false;
+				if(currentDiff->type == Mistake::Type_Change)
+				{
+					if(nextDiff->type == Mistake::Type_Deletion)
+						merge = true;
+					else if(nextDiff->type == Mistake::Type_Change)
+					{
+						// Merge if the merged word is closer to the target word
+						const QString targetWord = targetWords->at(currentDiff->pos);
+						merge = (compareStrings(newWord, targetWord).count() < compareStrings(currentDiff->previous, targetWord).count());
+					}
+				}
+				if(merge)
+				{
+					// old_word1[space]old_word2
+					int previousPos = currentDiff->previousPos;
+					sourceWords->replace(previousPos, newWord);
+					sourceWords->removeAt(previousPos + 1);
+					sourceList.replace(previousPos, newWord);
+					sourceList.removeAt(previousPos + 1);
+					mergeList.append(currentDiff->pos);
+					merged = true;
+					break;
+				}
 			}
-		}
-		if(differences.contains(wordDiff[i]["pos"].toInt()))
-		{
-			QVariantMap currentMap = differences[wordDiff[i]["pos"].toInt()];
-			if(currentMap.contains("previous"))
+			auto target = differences.find(wordDiff[i].pos);
+			if(target != differences.end())
 			{
-				QString previous = wordDiff[i]["previous"].toString();
-				currentMap["tmp_previous"] = previous;
-				if((previous == " ") || previous[0].isPunct() || (currentMap["tmp_previous"].toString() == " "))
-					currentMap["previous"] = currentMap["previous"].toString() + previous;
-				else
-					currentMap["previous"] = currentMap["previous"].toString() + " " + previous;
+				// Additions don't have any previous text
+				if(target->type != Mistake::Type_Addition)
+				{
+					QString previous = wordDiff[i].previous;
+					if((previous == " ") || previous[0].isPunct())
+						target->previous += previous;
+					else
+						target->previous += " " + previous;
+				}
 			}
-			differences[wordDiff[i]["pos"].toInt()] = currentMap;
+			else
+				differences.insert(wordDiff[i].pos, wordDiff[i]);
 		}
-		else
-			differences[wordDiff[i]["pos"].toInt()] = wordDiff[i];
-	}
+	} while(merged);
 	return differences;
 }
 
 /*! Compares input text with exercise text and finds mistakes. */
-QList<QVariantMap> StringUtils::findMistakes(QString exerciseText, QString input, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, QStringList *errorWords)
+MistakeList StringUtils::findMistakes(QString exerciseText, QString input, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, QStringList *errorWords)
 {
-	QList<QVariantMap> out;
+	return findMistakes(exerciseText, input, recordedCharacters, totalHits, errorWords, Settings::mistakeLimit() ? Settings::mistakeChars() : 0);
+}
+
+/*!
+ * Compares input text with exercise text and finds mistakes.\n
+ * There's max. one mistake per mistakeChars characters (0 means no limit). This function doesn't read settings, so it can be used in any thread.
+ */
+MistakeList StringUtils::findMistakes(QString exerciseText, QString input, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, QStringList *errorWords, int mistakeChars)
+{
+	MistakeList out;
 	int i;
-	// Split lines
-	QStringList exerciseLines = exerciseText.split('\n');
-	QStringList inputLines = input.split('\n');
-	// Split words in each line
-	QStringList exerciseWords, inputWords;
-	for(i = 0; i < exerciseLines.count(); i++)
-	{
-		if(i > 0)
-			exerciseWords += "\n";
-		exerciseWords += exerciseLines[i].split(' ');
-	}
-	exerciseWords = splitWordsByPunct(exerciseWords);
-	for(i = 0; i < inputLines.count(); i++)
-	{
-		if(i > 0)
-			inputWords += "\n";
-		inputWords += inputLines[i].split(' ');
-	}
-	inputWords = splitWordsByPunct(inputWords);
+	// Split words in each line by punctuation marks
+	QStringList exerciseWords = TokenTable(exerciseText).splitWordsByPunct();
+	QStringList inputWords = TokenTable(input).splitWordsByPunct();
 	auto differences = generateDiffList(&exerciseWords, &inputWords);
 	if(errorWords)
 		errorWords->clear();
@@ -410,59 +712,58 @@ QList<QVariantMap> StringUtils::findMistakes(QString exerciseText, QString input
 			pos--;
 		if(differences.contains(i))
 		{
+			const Mistake difference = differences.value(i);
 			if(errorWords)
-				errorWords->append(differences[i]["previous"].toString());
-			if(differences[i]["type"].toString() == "change")
+				errorWords->append(difference.previous);
+			if(difference.type == Mistake::Type_Change)
 			{
 				int wordStart = pos;
-				auto diff = compareStrings(differences[i]["previous"].toString(), inputWords[i], &recordedCharacters, &hits, &pos);
+				MistakeList diff = compareStrings(difference.previous, inputWords[i], &recordedCharacters, &hits, &pos);
 				// Ensure there's max. one mistake per n characters (depends on settings)
-				if(Settings::mistakeLimit())
+				if(mistakeChars > 0)
 				{
-					int charCount = Settings::mistakeChars();
+					int charCount = mistakeChars;
 					int lastMistakePos = -1;
 					for(int i2 = 0; i2 < diff.count(); i2++)
 					{
-						if((lastMistakePos != -1) && (diff[i2]["pos"].toInt() / charCount == lastMistakePos / charCount))
-							diff[i2].insert("disable", true);
+						if((lastMistakePos != -1) && (diff[i2].pos / charCount == lastMistakePos / charCount))
+							diff[i2].disable = true;
 						else
-							lastMistakePos = diff[i2]["pos"].toInt();
+							lastMistakePos = diff[i2].pos;
 					}
 				}
-				bool merged = (differences[i].contains("merged") && differences[i]["merged"].toBool());
 				// Translate mistake position
 				for(int i2 = 0; i2 < diff.count(); i2++)
 				{
-					QVariantMap currentMap = diff[i2];
-					if((currentMap["type"].toString() == "deletion") && (currentMap["previous"].toString() == " ") && !merged)
-						currentMap["pos"] = currentMap["pos"].toInt() - 1;
-					currentMap["pos"] = wordStart + currentMap["pos"].toInt();
-					diff[i2] = currentMap;
+					Mistake &mistake = diff[i2];
+					if((mistake.type == Mistake::Type_Deletion) && (mistake.previous == " ") && !difference.merged)
+						mistake.pos--;
+					mistake.pos += wordStart;
 				}
 				out += diff;
 				pos = wordStart + inputWords[i].count();
 			}
-			else if(differences[i]["type"].toString() == "deletion")
+			else if(difference.type == Mistake::Type_Deletion)
 			{
-				QVariantMap currentMap = differences[i];
-				currentMap["pos"] = pos > 0 && !inputWords[i][0].isPunct() ? pos - 1 : pos;
-				QString previous = currentMap["previous"].toString();
-				if((i > 0) && (previous != " ") && !previous[0].isPunct())
+				Mistake mistake = difference;
+				mistake.pos = pos > 0 && !inputWords[i][0].isPunct() ? pos - 1 : pos;
+				if((i > 0) && (mistake.previous != " ") && !mistake.previous[0].isPunct())
 				{
 					if(inputWords[i - 1] == "\n")
-						currentMap["previous"] = previous.prepend("\n");
+						mistake.previous.prepend("\n");
 					else
-						currentMap["previous"] = previous.prepend(" ");
+						mistake.previous.prepend(" ");
 				}
-				out += currentMap;
+				out += mistake;
 				pos += inputWords[i].count();
 			}
-			else if(differences[i]["type"].toString() == "addition")
+			else if(difference.type == Mistake::Type_Addition)
 			{
 				int k = i, previousPos = -1;
 				bool disable = false;
 				do
 				{
+					Mistake mistake = differences.value(k);
 					if(k > i)
 					{
 						pos++;
@@ -476,36 +777,33 @@ QList<QVariantMap> StringUtils::findMistakes(QString exerciseText, QString input
 							pos--;
 						for(int l = 0; l < pos - previousPos; l++)
 						{
-							QVariantMap currentMap = differences[k];
-							currentMap["pos"] = previousPos + l;
-							currentMap["disable"] = disable;
+							mistake.pos = previousPos + l;
+							mistake.disable = disable;
 							disable = true;
-							out += currentMap;
+							out += mistake;
 						}
 					}
 					if(inputWords[k].count() == 0)
 					{
-						QVariantMap currentMap = differences[k];
-						currentMap["pos"] = pos;
-						currentMap["disable"] = disable;
+						mistake.pos = pos;
+						mistake.disable = disable;
 						disable = true;
-						out += currentMap;
+						out += mistake;
 					}
 					else
 					{
 						for(int j = 0; j < inputWords[k].count(); j++)
 						{
-							QVariantMap currentMap = differences[k];
-							currentMap["pos"] = pos;
-							currentMap["disable"] = disable;
+							mistake.pos = pos;
+							mistake.disable = disable;
 							disable = true;
-							out += currentMap;
+							out += mistake;
 							pos++;
 						}
 					}
 					previousPos = pos;
 					k++;
-				} while((differences.contains(k)) && (differences[k]["type"].toString() == "addition"));
+				} while((differences.contains(k)) && (differences.value(k).type == Mistake::Type_Addition));
 				i = k - 1;
 				// TODO: Should we count hits in added words?
 			}
@@ -522,33 +820,48 @@ QList<QVariantMap> StringUtils::findMistakes(QString exerciseText, QString input
 	}
 	if(totalHits)
 		*totalHits = hits;
-	// Merge mistakes with the same position
-	QMap<int, QVariantMap *> mistakesMap;
+	// Merge mistakes with the same position (the first one is kept)
+	std::stable_sort(out.begin(), out.end(), [](const Mistake &a, const Mistake &b) {
+		return a.pos < b.pos;
+	});
+	int count = 0;
 	for(int i = 0; i < out.count(); i++)
 	{
-		int pos = out[i]["pos"].toInt();
-		if(mistakesMap.contains(pos))
-			mistakesMap[pos]->insert("previous", mistakesMap[pos]->value("previous").toString() + out[i]["previous"].toString());
+		if((count > 0) && (out[count - 1].pos == out[i].pos))
+			out[count - 1].previous += out[i].previous;
 		else
-			mistakesMap[pos] = &out[i];
+		{
+			if(count != i)
+				out[count] = out[i];
+			count++;
+		}
 	}
-	QList<QVariantMap> finalList;
-	for(int i = 0; i < mistakesMap.keys().count(); i++)
-		finalList.append(*mistakesMap[mistakesMap.keys().at(i)]);
-	return finalList;
+	out.resize(count);
+	return out;
 }
 
 /*! Validates a typing test. */
-QList<QVariantMap> StringUtils::validateExercise(QString exerciseText, QString inputText, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, int *mistakeCount, QStringList *errorWords, bool timed, int timeSecs)
+MistakeList StringUtils::validateExercise(QString exerciseText, QString inputText, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, int *mistakeCount, QStringList *errorWords, bool timed, int timeSecs)
 {
-	QList<QVariantMap> recordedMistakes;
+	return validateExercise(exerciseText, inputText, recordedCharacters, totalHits, mistakeCount, errorWords, timed, timeSecs, Settings::mistakeLimit() ? Settings::mistakeChars() : 0);
+}
+
+/*!
+ * Validates a typing test.\n
+ * There's max. one mistake per mistakeChars characters (0 means no limit). This function doesn't read settings, so it can be used without them.\n
+ * If bandWidth isn't null, it's set to the band width used to align the input of a timed exercise (see alignPrefix()), or 0 if the input wasn't aligned.
+ */
+MistakeList StringUtils::validateExercise(QString exerciseText, QString inputText, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, int *mistakeCount, QStringList *errorWords, bool timed, int timeSecs, int mistakeChars, int *bandWidth)
+{
+	MistakeList recordedMistakes;
+	if(bandWidth)
+		*bandWidth = 0;
 	if(timed)
 	{
-		QMap<int, QList<QVariantMap>> attempts;
-		QString newText = "";
-		int minValue = -1, minId = -1;
 		if(exerciseText.count() > 0)
 		{
+			// Repeat the exercise text (without the last character) until the time limit
+			QString newText = "";
 			int pos = 0, count = timeSecs * 10;
 			for(int i = 0; i < count; i++)
 			{
@@ -559,68 +872,206 @@ QList<QVariantMap> StringUtils::validateExercise(QString exerciseText, QString i
 					newText.remove(newText.count() - 1, 1);
 					pos = 0;
 				}
-				if((i % std::max(exerciseText.count(), inputText.count()) == 0) || (i == exerciseText.count() - 1) || (i + 1 >= count))
+			}
+			// Find the parts of the text which may have been typed
+			const QVector<int> candidates = alignPrefixes(newText, inputText, timedCandidateLimit, bandWidth);
+			// Compare them with the input text in parallel (each task has its own copy of the data)
+			auto evaluate = [inputText, recordedCharacters, mistakeChars](const QString candidateText) {
+				TimedAttempt attempt;
+				attempt.mistakes = findMistakes(candidateText, inputText, recordedCharacters, &attempt.totalHits, &attempt.errorWords, mistakeChars);
+				return attempt;
+			};
+			QList<TimedAttempt> attempts;
+#ifdef Q_OS_WASM
+			for(int i = 0; i < candidates.count(); i++)
+				attempts += evaluate(newText.left(candidates[i]));
+#else
+			QList<QFuture<TimedAttempt>> futures;
+			for(int i = 0; i < candidates.count(); i++)
+				futures += QtConcurrent::run(evaluate, newText.left(candidates[i]));
+			for(int i = 0; i < futures.count(); i++)
+				attempts += futures[i].result();
+#endif // Q_OS_WASM
+			// Use the candidate with the least mistakes (the longer one if there's more of them)
+			int minValue = -1;
+			for(int i = 0; i < attempts.count(); i++)
+			{
+				const TimedAttempt &attempt = attempts[i];
+				if((minValue == -1) || (attempt.mistakes.count() < minValue))
 				{
-					attempts[i] = StringUtils::findMistakes(newText, inputText, recordedCharacters, totalHits, errorWords);
-					if((minValue == -1) || (attempts[i].count() < minValue))
-					{
-						minValue = attempts[i].count();
-						minId = i;
-					}
+					minValue = attempt.mistakes.count();
+					recordedMistakes = attempt.mistakes;
+					if(totalHits)
+						*totalHits = attempt.totalHits;
+					if(errorWords)
+						*errorWords = attempt.errorWords;
 				}
 			}
-			if(minId == -1)
-				recordedMistakes = QList<QVariantMap>();
-			else
-				recordedMistakes = attempts[minId];
 		}
-		else
-			recordedMistakes = QList<QVariantMap>();
 	}
 	else
-		recordedMistakes = StringUtils::findMistakes(exerciseText, inputText, recordedCharacters, totalHits, errorWords);
-	QList<QVariantMap> mistakesToRemove;
+		recordedMistakes = StringUtils::findMistakes(exerciseText, inputText, recordedCharacters, totalHits, errorWords, mistakeChars);
+	// Remove mistakes after the end of the input text
 	*mistakeCount = 0;
+	int count = 0;
 	for(int i = 0; i < recordedMistakes.count(); i++)
 	{
-		if(recordedMistakes[i]["pos"].toInt() >= inputText.count())
-			mistakesToRemove += recordedMistakes[i];
-		else
-		{
-			if(!(recordedMistakes[i].contains("disable") && recordedMistakes[i]["disable"].toBool()))
-				*mistakeCount = (*mistakeCount) + 1;
-		}
+		if(recordedMistakes[i].pos >= inputText.count())
+			continue;
+		if(!recordedMistakes[i].disable)
+			*mistakeCount = (*mistakeCount) + 1;
+		if(count != i)
+			recordedMistakes[count] = recordedMistakes[i];
+		count++;
 	}
-	for(int i = 0; i < mistakesToRemove.count(); i++)
-		recordedMistakes.removeAll(mistakesToRemove[i]);
+	recordedMistakes.resize(count);
 	return recordedMistakes;
 }
 
 /*! Adds mistakes to an exercise with mistake correction enabled. */
-QString StringUtils::addMistakes(QString exerciseText, QList<QVariantMap> *recordedMistakes)
+QString StringUtils::addMistakes(QString exerciseText, MistakeList *recordedMistakes)
 {
 	Q_ASSERT(recordedMistakes);
 	QMap<int, int> mistakesMap;
 	for(int i = 0; i < recordedMistakes->count(); i++)
-		mistakesMap[recordedMistakes->at(i).value("pos").toInt()] = i;
+		mistakesMap[recordedMistakes->at(i).pos] = i;
 	int delta = 0;
 	QString out;
 	for(int i = 0; i <= exerciseText.count(); i++)
 	{
 		if(mistakesMap.contains(i))
 		{
-			QVariantMap currentMap = recordedMistakes->at(mistakesMap[i]);
-			out += currentMap["previous"].toString();
-			currentMap["pos"] = currentMap["pos"].toInt() + delta;
+			Mistake &currentMistake = (*recordedMistakes)[mistakesMap[i]];
+			out += currentMistake.previous;
+			currentMistake.pos += delta;
 			if(exerciseText[i] == '\n')
 			{
 				out += "\n";
 				delta++;
 			}
-			recordedMistakes->replace(mistakesMap[i], currentMap);
 		}
 		else
 			out += i < exerciseText.count() ? QString(exerciseText[i]) : QString();
 	}
 	return out;
 }
+
+/*!
+ * Returns the length of the beginning of text, which matches input the most.\n
+ * This is used to validate timed exercises, where the text is repeated and the user can stop anywhere.
+ * If there are more beginnings with the same edit distance, the longest one is used.\n
+ * If bandWidth isn't null, it's set to the band width of the alignment (see alignPrefixDistances()).
+ */
+int StringUtils::alignPrefix(QString text, QString input, int *bandWidth)
+{
+	return alignPrefixes(text, input, 1, bandWidth).first();
+}
+
+/*!
+ * Returns the edit distance between input and every beginning of text (the index is the length of the beginning).\n
+ * This is computed in one pass (semi-global alignment with a free end gap in text).
+ * The distance is at least |length - input length|, so beginnings longer than 2 * input length are skipped.\n
+ * If both texts are longer than bandedAlignmentThreshold, only cells near the diagonal are computed (see alignPrefixDistancesBanded()).
+ * The band width starts at minAlignmentBand and it's doubled until the lowest distance is proven to be correct.
+ * Distances higher than the lowest distance may be too high in that case.
+ * The final band width is stored in bandWidth.
+ */
+QVector<int> StringUtils::alignPrefixDistances(const QString &text, const QString &input, int *bandWidth)
+{
+	int length = std::min(text.count(), 2 * input.count());
+	int fullWidth = std::max(length, input.count());
+	if((length >= bandedAlignmentThreshold) && (input.count() >= bandedAlignmentThreshold))
+	{
+		for(int band = minAlignmentBand; band < fullWidth; band *= 2)
+		{
+			QVector<int> distances = alignPrefixDistancesBanded(text, input, band);
+			// Paths with distance <= band never leave the band, so their distance is correct
+			if(*std::min_element(distances.constBegin(), distances.constEnd()) <= band)
+			{
+				if(bandWidth)
+					*bandWidth = band;
+				return distances;
+			}
+		}
+	}
+	if(bandWidth)
+		*bandWidth = fullWidth;
+	QVector<int> previous(length + 1), current(length + 1);
+	for(int i = 0; i <= length; i++)
+		previous[i] = i;
+	const QChar *textData = text.constData();
+	const QChar *inputData = input.constData();
+	for(int j = 1; j <= input.count(); j++)
+	{
+		current[0] = j;
+		QChar inputChar = inputData[j - 1];
+		for(int i = 1; i <= length; i++)
+		{
+			int value = previous[i - 1] + (textData[i - 1] == inputChar ? 0 : 1);
+			value = std::min(value, previous[i] + 1);
+			value = std::min(value, current[i - 1] + 1);
+			current[i] = value;
+		}
+		previous.swap(current);
+	}
+	return previous;
+}
+
+/*!
+ * Computes the same distances as alignPrefixDistances(), but only cells within band of the diagonal are evaluated (Ukkonen's cut-off).\n
+ * Every row stores 2 * band + 1 cells, so it takes O(input length * band) time.
+ * Distances which are not higher than band are correct. The other distances may be too high.
+ */
+QVector<int> StringUtils::alignPrefixDistancesBanded(const QString &text, const QString &input, int band)
+{
+	const int length = std::min(text.count(), 2 * input.count());
+	const int count = input.count();
+	const int width = 2 * band + 1;
+	const int infinity = length + count + 1;
+	// Cell (j, i) is stored at index i - j + band
+	QVector<int> previous(width, infinity), current(width, infinity);
+	for(int i = 0; i <= std::min(length, band); i++)
+		previous[i + band] = i;
+	const QChar *textData = text.constData();
+	const QChar *inputData = input.constData();
+	for(int j = 1; j <= count; j++)
+	{
+		std::fill(current.begin(), current.end(), infinity);
+		QChar inputChar = inputData[j - 1];
+		int last = std::min(length, j + band);
+		for(int i = std::max(0, j - band); i <= last; i++)
+		{
+			int index = i - j + band;
+			int value = j;
+			if(i > 0)
+			{
+				value = previous[index] + (textData[i - 1] == inputChar ? 0 : 1);
+				if(index + 1 < width)
+					value = std::min(value, previous[index + 1] + 1);
+				if(index > 0)
+					value = std::min(value, current[index - 1] + 1);
+			}
+			current[index] = value;
+		}
+		previous.swap(current);
+	}
+	QVector<int> out(length + 1, infinity);
+	int last = std::min(length, count + band);
+	for(int i = std::max(0, count - band); i <= last; i++)
+		out[i] = previous[i - count + band];
+	return out;
+}
+
+/*! Returns lengths of max. limit beginnings of text with the lowest edit distance from input, the longest first. \see alignPrefix() */
+QVector<int> StringUtils::alignPrefixes(const QString &text, const QString &input, int limit, int *bandWidth)
+{
+	const QVector<int> distances = alignPrefixDistances(text, input, bandWidth);
+	int minDistance = *std::min_element(distances.constBegin(), distances.constEnd());
+	QVector<int> out;
+	for(int i = distances.count() - 1; (i >= 0) && (out.count() < limit); i--)
+	{
+		if(distances[i] == minDistance)
+			out += i;
+	}
+	return out;
+}
@@ -0,0 +1,179 @@
+/*
+ * TokenTable.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "TokenTable.h"
+
+/*! Constructs an empty TokenTable. */
+TokenTable::TokenTable(void)
+{
+	setText(QString());
+}
+
+/*! Constructs TokenTable and splits the text. */
+TokenTable::TokenTable(const QString text)
+{
+	setText(text);
+}
+
+/*! Splits the text into words and tokens. */
+void TokenTable::setText(const QString text)
+{
+	m_text = text;
+	words.clear();
+	tokens.clear();
+	const QChar *data = m_text.constData();
+	const int count = m_text.count();
+	int line = 0, wordStart = 0;
+	for(int i = 0; i <= count; i++)
+	{
+		if((i < count) && (data[i] != ' ') && (data[i] != '\n'))
+			continue;
+		Word word;
+		word.start = wordStart;
+		word.length = i - wordStart;
+		word.line = line;
+		word.firstToken = tokens.count();
+		// Split the word by punctuation marks
+		int tokenStart = wordStart;
+		for(int j = wordStart; j <= i; j++)
+		{
+			if((j < i) && !data[j].isPunct())
+				continue;
+			if(j > tokenStart)
+			{
+				Token token;
+				token.start = tokenStart;
+				token.length = j - tokenStart;
+				token.line = line;
+				token.tokenClass = Class_Word;
+				tokens.append(token);
+			}
+			if(j < i)
+			{
+				Token token;
+				token.start = j;
+				token.length = 1;
+				token.line = line;
+				token.tokenClass = Class_Punct;
+				tokens.append(token);
+			}
+			tokenStart = j + 1;
+		}
+		word.tokenCount = tokens.count() - word.firstToken;
+		words.append(word);
+		if((i < count) && (data[i] == '\n'))
+			line++;
+		wordStart = i + 1;
+	}
+	m_lineCount = line + 1;
+}
+
+/*! Returns the text. */
+QString TokenTable::text(void) const
+{
+	return m_text;
+}
+
+/*! Returns the number of lines. */
+int TokenTable::lineCount(void) const
+{
+	return m_lineCount;
+}
+
+/*! Returns the number of words (including empty words). */
+int TokenTable::wordCount(void) const
+{
+	return words.count();
+}
+
+/*! Returns the span of the word. */
+TokenTable::Word TokenTable::word(int index) const
+{
+	return words[index];
+}
+
+/*! Returns the text of the word. */
+QString TokenTable::wordText(int index) const
+{
+	return m_text.mid(words[index].start, words[index].length);
+}
+
+/*! Returns the index of the word at the position in the text, or -1 if there's a separator. */
+int TokenTable::wordAt(int position) const
+{
+	// Find the last word which starts before the position
+	auto target = std::upper_bound(words.constBegin(), words.constEnd(), position, [](int pos, const Word &word) {
+		return pos < word.start;
+	});
+	if(target == words.constBegin())
+		return -1;
+	target--;
+	if(position >= target->start + target->length)
+		return -1;
+	return target - words.constBegin();
+}
+
+/*! Returns the number of tokens. */
+int TokenTable::tokenCount(void) const
+{
+	return tokens.count();
+}
+
+/*! Returns the span of the token. */
+TokenTable::Token TokenTable::token(int index) const
+{
+	return tokens[index];
+}
+
+/*! Returns the text of the token. */
+QString TokenTable::tokenText(int index) const
+{
+	return m_text.mid(tokens[index].start, tokens[index].length);
+}
+
+/*!
+ * Returns the list of words split by punctuation marks, which is used to find mistakes (see StringUtils#findMistakes()).\n
+ * Lines are separated by "\n". If a word starts or ends with a punctuation mark, there's a " " before or after it.
+ */
+QStringList TokenTable::splitWordsByPunct(void) const
+{
+	QStringList out;
+	out.reserve(tokens.count() + words.count());
+	for(int i = 0; i < words.count(); i++)
+	{
+		const Word &word = words[i];
+		if((i > 0) && (word.line != words[i - 1].line))
+			out += "\n";
+		if(word.tokenCount == 0)
+		{
+			out += "";
+			continue;
+		}
+		const int lastToken = word.firstToken + word.tokenCount - 1;
+		if(tokens[word.firstToken].tokenClass == Class_Punct)
+			out += " ";
+		for(int j = word.firstToken; j <= lastToken; j++)
+			out += tokenText(j);
+		if(tokens[lastToken].tokenClass == Class_Punct)
+			out += " ";
+	}
+	return out;
+}
@@ -0,0 +1,43 @@
+/*
+ * ValidationSettings.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ValidationSettings.h"
+
+const QString ValidationSettings::errorPenaltyKey = "main/errorpenalty";
+const QString ValidationSettings::mistakeLimitKey = "main/mistakelimit";
+const QString ValidationSettings::mistakeCharsKey = "main/mistakechars";
+
+/*! Returns the number of hits subtracted from net hits on every mistake. \see Settings#errorPenalty() */
+int ValidationSettings::errorPenalty(const QSettings &settings)
+{
+	return settings.value(errorPenaltyKey, defaultErrorPenalty).toInt();
+}
+
+/*!
+ * Returns the number of characters in one word with max. 1 mistake, or 0 if the number of mistakes isn't limited.
+ * \see Settings#mistakeLimit()
+ * \see Settings#mistakeChars()
+ */
+int ValidationSettings::mistakeChars(const QSettings &settings)
+{
+	if(!settings.value(mistakeLimitKey, defaultMistakeLimit).toBool())
+		return 0;
+	return settings.value(mistakeCharsKey, defaultMistakeChars).toInt();
+}
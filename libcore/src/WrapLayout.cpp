@@ -0,0 +1,206 @@
+/*
+ * WrapLayout.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "WrapLayout.h"
+#include "ConfigParser.h"
+
+/*!
+ * Wraps the text and finds the line breaks.\n
+ * Nothing is done if the text and line length didn't change.
+ * \see ConfigParser#initExercise()
+ */
+void WrapLayout::setText(const QString text, int lineLength)
+{
+	if(!sourceWrapped && (lineLength == sourceLineLength) && (text == sourceText))
+		return;
+	sourceText = text;
+	sourceLineLength = lineLength;
+	sourceWrapped = false;
+	wrappedText = ConfigParser::initExercise(text, lineLength);
+	lineBreaks = findLineBreaks(wrappedText);
+}
+
+/*!
+ * Uses text which is already wrapped (for example from ConfigParser#wrappedExerciseText()).\n
+ * Nothing is done if the text didn't change.
+ */
+void WrapLayout::setWrappedText(const QString text)
+{
+	if(sourceWrapped && (text == sourceText))
+		return;
+	sourceText = text;
+	sourceLineLength = -1;
+	sourceWrapped = true;
+	wrappedText = text;
+	lineBreaks = findLineBreaks(wrappedText);
+}
+
+/*!
+ * Adds a new line and the text repeated count times after the wrapped text.\n
+ * The repeated text isn't wrapped. Use count 0 to remove it.
+ */
+void WrapLayout::setRepeatedText(const QString text, int count)
+{
+	if(count <= 0)
+	{
+		repeatedText = "";
+		repeatedLineBreaks.clear();
+		repeatCount = 0;
+		return;
+	}
+	if(text != repeatedText)
+	{
+		repeatedText = text;
+		repeatedLineBreaks = findLineBreaks(repeatedText);
+	}
+	repeatCount = count;
+}
+
+/*! Returns the wrapped text (without the repeated text). */
+QString WrapLayout::text(void)
+{
+	return wrappedText;
+}
+
+/*! Returns the length of the whole text (including the repeated text). */
+int WrapLayout::length(void)
+{
+	if(repeatCount == 0)
+		return wrappedText.count();
+	return wrappedText.count() + 1 + repeatCount * repeatedText.count();
+}
+
+/*! Returns the number of lines. */
+int WrapLayout::lineCount(void)
+{
+	return lineBreakCount() + 1;
+}
+
+/*! Returns the position of the first character of the line. */
+int WrapLayout::lineStart(int index)
+{
+	if(index <= 0)
+		return 0;
+	return lineBreak(index - 1) + 1;
+}
+
+/*! Returns the length of the line (without the new line character). */
+int WrapLayout::lineLength(int index)
+{
+	int end;
+	if(index < lineBreakCount())
+		end = lineBreak(index);
+	else
+		end = length();
+	return end - lineStart(index);
+}
+
+/*! Returns the line (without the new line character). */
+QString WrapLayout::line(int index)
+{
+	if((index < 0) || (index >= lineCount()))
+		return "";
+	return mid(lineStart(index), lineLength(index));
+}
+
+/*!
+ * Returns maxLines lines starting with firstLine, separated by new line characters.\n
+ * All remaining lines are returned if maxLines is negative.
+ */
+QString WrapLayout::window(int firstLine, int maxLines)
+{
+	int count = lineCount();
+	if((firstLine < 0) || (firstLine >= count) || (maxLines == 0))
+		return "";
+	int lastLine = count - 1;
+	if((maxLines > 0) && (firstLine + maxLines < count))
+		lastLine = firstLine + maxLines - 1;
+	int start = lineStart(firstLine);
+	return mid(start, lineStart(lastLine) + lineLength(lastLine) - start);
+}
+
+/*! Returns positions of new line characters in the text. */
+QVector<int> WrapLayout::findLineBreaks(const QString &text)
+{
+	QVector<int> out;
+	int i, count = text.count();
+	for(i = 0; i < count; i++)
+	{
+		if(text[i] == '\n')
+			out += i;
+	}
+	return out;
+}
+
+/*! Returns the number of new line characters in the whole text. */
+int WrapLayout::lineBreakCount(void)
+{
+	if(repeatCount == 0)
+		return lineBreaks.count();
+	return lineBreaks.count() + 1 + repeatCount * repeatedLineBreaks.count();
+}
+
+/*! Returns the position of a new line character in the whole text. */
+int WrapLayout::lineBreak(int index)
+{
+	if(index < lineBreaks.count())
+		return lineBreaks[index];
+	if(index == lineBreaks.count())
+		return wrappedText.count();
+	// Line breaks in the repeated text
+	int repeatedIndex = index - lineBreaks.count() - 1;
+	int copy = repeatedIndex / repeatedLineBreaks.count();
+	return wrappedText.count() + 1 + copy * repeatedText.count() + repeatedLineBreaks[repeatedIndex % repeatedLineBreaks.count()];
+}
+
+/*! Returns a part of the whole text. Only the returned part is copied. */
+QString WrapLayout::mid(int position, int n)
+{
+	QString out;
+	n = std::min(n, length() - position);
+	if((position < 0) || (n <= 0))
+		return out;
+	out.reserve(n);
+	int wrappedLength = wrappedText.count();
+	while(n > 0)
+	{
+		int part;
+		if(position < wrappedLength)
+		{
+			part = std::min(n, wrappedLength - position);
+			out.append(wrappedText.constData() + position, part);
+		}
+		else if(position == wrappedLength)
+		{
+			part = 1;
+			out += '\n';
+		}
+		else
+		{
+			int repeatedPos = (position - wrappedLength - 1) % repeatedText.count();
+			part = std::min(n, repeatedText.count() - repeatedPos);
+			out.append(repeatedText.constData() + repeatedPos, part);
+		}
+		position += part;
+		n -= part;
+	}
+	return out;
+}
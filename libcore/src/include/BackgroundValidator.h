@@ -0,0 +1,105 @@
+/*
+ * BackgroundValidator.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BACKGROUNDVALIDATOR_H
+#define BACKGROUNDVALIDATOR_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QObject>
+#include <QFuture>
+#include <QFutureWatcher>
+#include "StringUtils.h"
+
+/*!
+ * \brief The BackgroundValidator class validates the exercise in another thread while it's being typed.
+ *
+ * Every keystroke is passed to the validator (see addCharacter() and removeCharacter()).
+ * The whole input is validated by StringUtils#validateExercise() in the thread pool. If more keys are pressed
+ * while a validation is running, only the latest input is validated after it finishes.\n
+ * When the exercise ends, result() returns the future of the last validation if it was done with the whole input,
+ * so the result is often ready when the exercise ends. If the last key was pressed while a validation was running,
+ * the whole input is validated again, so the time it takes still depends on the length of the input.
+ *
+ * The validation isn't incremental. StringUtils#findMistakes() compares the words using the longest common subsequence
+ * of the whole word lists and merges split words afterwards, so a new word can change mistakes in the words before it.
+ * Each validation uses the whole input, so the result is always the same as the result of StringUtils#validateExercise().
+ *
+ * Settings aren't read by the validator. Pass the mistake limit to start().
+ *
+ * Example usage:
+ * \code
+ * BackgroundValidator validator;
+ * validator.start("Some text", Settings::mistakeLimit() ? Settings::mistakeChars() : 0);
+ * validator.addCharacter("S", 2);
+ * // ...
+ * QFuture<BackgroundValidator::Result> future = validator.result();
+ * printf("%d\n", future.result().mistakeCount);
+ * \endcode
+ */
+class CORE_LIB_EXPORT BackgroundValidator : public QObject
+{
+		Q_OBJECT
+	public:
+		struct Result
+		{
+				MistakeList mistakes;
+				int totalHits = 0;
+				int mistakeCount = 0;
+				QStringList errorWords;
+				int bandWidth = 0;
+		};
+
+		explicit BackgroundValidator(QObject *parent = nullptr);
+		void start(const QString exerciseText, int mistakeChars, bool timed = false, int timeSecs = 0);
+		void stop(void);
+		void addCharacter(const QString text, int hits);
+		void removeCharacter(void);
+		void chopInput(void);
+		bool hasResult(void) const;
+		QFuture<Result> result(void);
+		static Result validate(const QString exerciseText, const QString inputText, const QVector<QPair<QString, int>> recordedCharacters, int mistakeChars, bool timed = false, int timeSecs = 0);
+
+	private:
+		bool active = false;
+		QString m_exerciseText;
+		int m_mistakeChars = 0;
+		bool m_timed = false;
+		int m_timeSecs = 0;
+		QString input;
+		QVector<QPair<QString, int>> recordedCharacters;
+		bool pending = false;
+		bool jobStarted = false;
+		QString jobInput;
+		QVector<QPair<QString, int>> jobCharacters;
+		QFuture<Result> future;
+		QFutureWatcher<Result> watcher;
+		void scheduleValidation(void);
+		static QFuture<Result> readyFuture(const Result &result);
+
+	private slots:
+		void finishValidation(void);
+};
+
+#endif // BACKGROUNDVALIDATOR_H
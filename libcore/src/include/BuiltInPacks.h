@@ -29,6 +29,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QFile>
 
 /*! \brief The BuiltInPacks class provides functions for built-in pack settings. */
 class CORE_LIB_EXPORT BuiltInPacks : public QObject
@@ -36,6 +37,7 @@ class CORE_LIB_EXPORT BuiltInPacks : public QObject
 		Q_OBJECT
 	public:
 		static QString packName(QString rawName);
+		static QString packPath(QString rawName);
 };
 
 #endif // BUILTINPACKS_H
@@ -0,0 +1,99 @@
+/*
+ * CompiledPack.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPILEDPACK_H
+#define COMPILEDPACK_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+
+class ConfigParser;
+
+/*!
+ * \brief The CompiledPack class provides functions for the compiled (binary) pack format.
+ *
+ * Built-in packs are compiled at build time, so they don't have to be parsed when they're opened.
+ * ConfigParser detects compiled packs and uses this class to read them.
+ *
+ * All numbers are 32-bit little endian integers and all strings are UTF-16 (little endian).\n
+ * The file starts with a header:
+ *  - magic number ("OTPC")
+ *  - format version
+ *  - number of lessons, sublessons and exercises
+ *  - offset of the lesson, sublesson and exercise table
+ *  - offset and size (in bytes) of the string pool
+ *
+ * Lesson table entry: lesson ID, index of the first sublesson, number of sublessons, lesson description.\n
+ * Sublesson table entry: sublesson ID, index of the first exercise, number of exercises.\n
+ * Exercise table entry: exercise ID, line number, repeat flag, repeat type, repeat limit, line length,
+ * raw text and text (raw text without escape sequences).\n
+ * Tables are sorted by ID. Strings are stored as offset and length (in UTF-16 code units) in the string pool.
+ * Identical strings (for example lesson descriptions) are stored only once.
+ */
+class CORE_LIB_EXPORT CompiledPack
+{
+	public:
+		static QByteArray compile(ConfigParser *parser);
+		static bool isCompiled(const QByteArray data);
+		bool load(QFile *file);
+		void unload(void);
+		bool isLoaded(void);
+		int lessonCount(void);
+		int sublessonCount(int lesson);
+		int exerciseCount(int lesson, int sublesson);
+		int exerciseLine(int lesson, int sublesson, int exercise);
+		bool exerciseRepeatBool(int lesson, int sublesson, int exercise);
+		QString exerciseRepeatType(int lesson, int sublesson, int exercise);
+		int exerciseRepeatLimit(int lesson, int sublesson, int exercise);
+		int exerciseLineLength(int lesson, int sublesson, int exercise);
+		QString lessonDesc(int lesson);
+		QString exerciseRawText(int lesson, int sublesson, int exercise);
+		QString exerciseText(int lesson, int sublesson, int exercise);
+
+	private:
+		enum Layout
+		{
+			FormatVersion = 1,
+			HeaderSize = 40,
+			LessonEntrySize = 20,
+			SublessonEntrySize = 12,
+			ExerciseEntrySize = 44
+		};
+
+		const uchar *packData = nullptr;
+		qint64 packSize = 0;
+		QByteArray ownedData;
+		bool zeroCopy = false;
+		quint32 value(quint32 offset);
+		QString string(quint32 offset);
+		int findEntry(quint32 tableOffset, quint32 entrySize, quint32 first, quint32 count, int id);
+		int findLesson(int lesson);
+		int findSublesson(int lesson, int sublesson);
+		quint32 findExercise(int lesson, int sublesson, int exercise);
+};
+
+#endif // COMPILEDPACK_H
@@ -31,12 +31,36 @@
 #include <QFile>
 #include <QBuffer>
 #include <QString>
+#include <QMap>
+#include <QVector>
+#include <QCache>
+#include <QMutex>
 #include "StringUtils.h"
+#include "CompiledPack.h"
 
 namespace publicPos {
 	extern int CORE_LIB_EXPORT currentLesson, currentSublesson, currentExercise;
 }
 
+/*!
+ * \brief The ExerciseRecord struct contains the fields of one exercise line.
+ *
+ * It's produced by ConfigParser#parseExerciseLine().
+ * The raw text isn't copied, it starts at textPos in the parsed line.
+ */
+struct ExerciseRecord
+{
+		int lesson = 0;
+		int sublesson = 0;
+		int exercise = 0;
+		bool repeat = false;
+		QString repeatType;
+		int repeatLimit = 0;
+		int lineLength = 0;
+		QString desc;
+		int textPos = 0;
+};
+
 // TODO: Add a link to pack file format documentation.
 /*!
  * \brief The ConfigParser class provides functions for the pack file format.
@@ -48,6 +72,17 @@ namespace publicPos {
  * printf("There are %d lessons in the opened pack.\n",parser.lessonCount());
  * \endcode
  *
+ * The pack is indexed when it's opened (see open() and loadToBuffer()),
+ * so the query functions don't have to read the whole pack again.
+ * Pack files are mapped to memory and only the lines of requested exercises are decoded.\n
+ * Compiled packs (see CompiledPack) are detected by open() and they're read-only.
+ *
+ * Once a pack is opened, the query functions (except data()) can be called from multiple threads,
+ * as long as nothing opens, closes or modifies the pack at the same time (see PackRegistry).
+ *
+ * Generated exercise text (see exerciseText() and wrappedExerciseText()) is cached,
+ * so repeating an exercise doesn't generate the text again.
+ *
  * Closing the file isn't required most of the time, but there might be
  * some special situations, in which you'll have to close the file.\n
  * For example if you need to open the file again before destroying the ConfigParser object.
@@ -62,8 +97,10 @@ class CORE_LIB_EXPORT ConfigParser : public QObject
 		explicit ConfigParser(QObject *parent = nullptr);
 		static const int defaultRepeatLimit = 128;
 		static const int defaultLineLength = 60;
+		static const int textCacheMaxCost = 1048576;
 		bool open(const QString fileName);
 		void loadToBuffer(const QByteArray content);
+		bool appendToBuffer(const QByteArray data);
 		QByteArray data(void);
 		bool bufferOpened(void);
 		void close(void);
@@ -76,6 +113,9 @@ class CORE_LIB_EXPORT ConfigParser : public QObject
 		QString exerciseRepeatType(int lesson, int sublesson, int exercise);
 		int exerciseRepeatLimit(int lesson, int sublesson, int exercise);
 		int exerciseLineLength(int lesson, int sublesson, int exercise);
+		ExerciseRecord exerciseRecord(int lesson, int sublesson, int exercise);
+		static ExerciseRecord parseExerciseLine(const QString line);
+		static QString rawText(const QString line, const ExerciseRecord &record);
 		QString lessonDesc(int lesson);
 		static QString parseDesc(QString desc);
 		static QString sublessonName(int id);
@@ -84,25 +124,63 @@ class CORE_LIB_EXPORT ConfigParser : public QObject
 		static QString exerciseTr(int id);
 		QString exerciseRawText(int lesson, int sublesson, int exercise);
 		QString exerciseText(int lesson, int sublesson, int exercise);
+		QString wrappedExerciseText(int lesson, int sublesson, int exercise, int lineLength);
+		int textCacheHits(void);
+		int textCacheMisses(void);
 		static QString initExercise(QString exercise, int lineLength);
 		static QString initExercise(QString exercise, int lineLength, bool lineCountLimit, int currentLine);
 		static QString initText(QString rawText);
+		static QString generateText(QString rawText, bool repeat, QString repeatType, int repeatLimit);
 		bool addExercise(int lesson, int sublesson, int exercise, bool repeat, QString repeatType, int repeatLimit, int lineLength, QString desc, QString rawText);
+		static QByteArray formatExercise(int lesson, int sublesson, int exercise, bool repeat, QString repeatType, int repeatLimit, int lineLength, QString desc, QString rawText);
 
 	private:
+		friend class CompiledPack;
 		QFile configFile;
 		QBuffer configBuffer;
 		QIODevice *currentDevice;
 		bool reopen(QIODevice::OpenMode mode);
-		int exerciseID(const QString line, const int part);
+
+		struct IndexedExercise
+		{
+				int line;
+				qint64 offset;
+				int length;
+				ExerciseRecord record;
+		};
+
+		struct IndexedLesson
+		{
+				QString desc;
+				QMap<int, QMap<int, IndexedExercise>> sublessons;
+		};
+
+		QMap<int, IndexedLesson> packIndex;
+		int indexedLines = 0;
+		qint64 indexedSize = 0;
+		bool indexTerminated = true;
+		void buildIndex(void);
+		void updateIndex(void);
+		void clearIndex(void);
+		const char *packData = nullptr;
+		qint64 packSize = 0;
+		uchar *mappedData = nullptr;
+		QByteArray packContent;
+		bool mapPack(void);
+		void unmapPack(void);
+		const IndexedExercise *indexedExercise(int lesson, int sublesson, int exercise);
+		CompiledPack compiledPack;
 		QString lineOf(int lesson, int sublesson, int exercise);
-		bool exerciseRepeatBool(const QString config);
-		QString exerciseRepeatType(const QString config);
-		QString exerciseRepeatConfig(const QString line);
-		QString exerciseAttribute(const QString config, const int id);
-		QString exerciseAttributes(const QString line);
-		QString exerciseRawText(const QString line);
-		static QString generateText(QString rawText, bool repeat, QString repeatType, int repeatLimit);
+		static ExerciseRecord parseHeader(const char *line, qint64 length);
+		QCache<QString, QString> textCache;
+		QMutex textCacheMutex;
+		int cacheHits = 0;
+		int cacheMisses = 0;
+		QString packId;
+		int packRevision = 0;
+		void updatePackId(void);
+		void invalidateTextCache(void);
+		QString textCacheKey(int lesson, int sublesson, int exercise, int lineLength);
 };
 
 #endif // CONFIGPARSER_H
@@ -38,6 +38,7 @@
 #include <QPainter>
 #include <QAbstractTextDocumentLayout>
 #include "ThemeEngine.h"
+#include "Mistake.h"
 
 namespace Ui {
 	class ExportDialog;
@@ -52,7 +53,7 @@ class CORE_LIB_EXPORT ExportDialog : public QDialog
 {
 		Q_OBJECT
 	public:
-		explicit ExportDialog(QString text, QVariantMap result, QList<QVariantMap> mistakes, QWidget *parent = nullptr);
+		explicit ExportDialog(QString text, QVariantMap result, MistakeList mistakes, QWidget *parent = nullptr);
 		~ExportDialog();
 		void setStudentName(QString name);
 		QString studentName(void);
@@ -67,7 +68,7 @@ class CORE_LIB_EXPORT ExportDialog : public QDialog
 		Ui::ExportDialog *ui;
 		QString inputText, exportHtml;
 		QVariantMap performanceResult;
-		QList<QVariantMap> recordedMistakes;
+		MistakeList recordedMistakes;
 
 	private slots:
 		void updateTable(void);
@@ -31,6 +31,9 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include "ConfigParser.h"
+#include "BuiltInPacks.h"
+#include "PackRegistry.h"
+#include "Settings.h"
 
 namespace Ui {
 	class LoadExerciseDialog;
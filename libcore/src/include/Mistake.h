@@ -0,0 +1,65 @@
+/*
+ * Mistake.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MISTAKE_H
+#define MISTAKE_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QString>
+#include <QVector>
+#include <QVariantMap>
+
+/*!
+ * \brief The Mistake struct holds a difference between the exercise text and the input text.
+ *
+ * pos is the position in the input text. previous is the expected text (it's empty in additions)
+ * and previousPos is its position in the exercise text (or -1 if it's unknown).\n
+ * Disabled mistakes are displayed, but they're not counted (see Settings#mistakeLimit()).
+ *
+ * Mistakes are stored in a MistakeList. Use toVariantMap() to pass a mistake to addons.
+ */
+struct CORE_LIB_EXPORT Mistake
+{
+		enum Type
+		{
+			Type_Change,
+			Type_Deletion,
+			Type_Addition
+		};
+
+		int pos = 0;
+		int previousPos = -1;
+		Type type = Type_Change;
+		bool merged = false;
+		bool disable = false;
+		QString previous;
+		QVariantMap toVariantMap(void) const;
+};
+
+Q_DECLARE_TYPEINFO(Mistake, Q_MOVABLE_TYPE);
+
+typedef QVector<Mistake> MistakeList;
+
+#endif // MISTAKE_H
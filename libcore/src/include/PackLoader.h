@@ -0,0 +1,95 @@
+/*
+ * PackLoader.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKLOADER_H
+#define PACKLOADER_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QFuture>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include "ConfigParser.h"
+
+/*!
+ * \brief The PackLoader class loads large packs progressively.
+ *
+ * The pack file is read in chunks by a worker thread. Every chunk is added to a buffer
+ * in parser() (see ConfigParser#appendToBuffer()), so the loaded lessons can be used before the whole pack is read.\n
+ * Lessons are expected to be sorted. A lesson is reported by lessonsDiscovered() when the next lesson starts
+ * or when the whole pack is read.
+ *
+ * Loading is cancelled when cancel() or load() is called.
+ *
+ * Example usage:
+ * \code
+ * PackLoader loader;
+ * connect(&loader, &PackLoader::lessonsDiscovered, this, [&loader](int first, int last) {
+ *     // Lessons first - last can be used now
+ *     printf("%d\n", loader.parser()->exerciseCount(first, 1));
+ * });
+ * loader.load("/path/to/pack.typer");
+ * \endcode
+ */
+class CORE_LIB_EXPORT PackLoader : public QObject
+{
+		Q_OBJECT
+	public:
+		static const int chunkSize = 262144;
+		static const qint64 streamingThreshold = 4194304;
+		explicit PackLoader(QObject *parent = nullptr);
+		~PackLoader();
+		void load(const QString fileName);
+		void cancel(void);
+		bool isLoading(void);
+		QString fileName(void);
+		QSharedPointer<ConfigParser> parser(void);
+
+	private:
+		QSharedPointer<ConfigParser> m_parser;
+		QString m_fileName;
+		QAtomicInt generation;
+		bool loading = false;
+		int reportedLessons = 0;
+		QFuture<void> future;
+		QElapsedTimer timer;
+		void readFile(const QString fileName, int loadGeneration);
+		void reportLessons(int lastLesson);
+
+	private slots:
+		void addChunk(const QByteArray chunk, int loadGeneration);
+		void finishLoading(int loadGeneration, bool success);
+
+	signals:
+		/*! A signal, which is emitted when lessons first - last are loaded. */
+		void lessonsDiscovered(int first, int last);
+		/*! A signal, which is emitted when the whole pack is loaded. */
+		void finished(void);
+		/*! A signal, which is emitted when the pack can't be opened. */
+		void failed(void);
+};
+
+#endif // PACKLOADER_H
@@ -0,0 +1,83 @@
+/*
+ * PackRegistry.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKREGISTRY_H
+#define PACKREGISTRY_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QSharedPointer>
+#include <QFuture>
+#include <QMutex>
+#include <QMap>
+#include "ConfigParser.h"
+
+/*!
+ * \brief The PackRegistry class keeps opened and indexed packs.
+ *
+ * Packs can be indexed in the background (see preload()), for example while the splash screen is shown.
+ * pack() returns the indexed pack, so switching to another pack doesn't have to read it again.
+ *
+ * The returned ConfigParser is shared and it can be used from multiple threads,
+ * but it must not be opened, closed or modified. Use a separate ConfigParser for that.\n
+ * Custom packs are loaded to a buffer, so the file isn't kept open and it can be changed by the pack editor.
+ * A custom pack is indexed again when its file changes or when it's removed from the registry (see remove()).
+ *
+ * Example usage:
+ * \code
+ * PackRegistry::preloadAll();
+ * // ...
+ * QSharedPointer<ConfigParser> parser = PackRegistry::pack(BuiltInPacks::packPath("en_US-default-A"));
+ * if(parser)
+ *     printf("There are %d lessons in the pack.\n", parser->lessonCount());
+ * \endcode
+ */
+class CORE_LIB_EXPORT PackRegistry
+{
+	public:
+		static const int recentPackLimit = 10;
+		static void preload(const QStringList paths);
+		static void preloadAll(void);
+		static QSharedPointer<ConfigParser> pack(const QString path);
+		static void insert(const QString path, QSharedPointer<ConfigParser> parser);
+		static void remove(const QString path);
+		static void addRecentPack(const QString path);
+		static QStringList builtInPacks(void);
+
+	private:
+		struct Entry
+		{
+				QFuture<QSharedPointer<ConfigParser>> future;
+				QSharedPointer<ConfigParser> parser;
+				QString fileId;
+		};
+
+		static QMutex mutex;
+		static QMap<QString, Entry> packs;
+		static QSharedPointer<ConfigParser> indexPack(const QString path);
+		static bool isCustomPack(const QString path);
+		static QString fileId(const QString path);
+};
+
+#endif // PACKREGISTRY_H
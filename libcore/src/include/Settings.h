@@ -78,6 +78,7 @@
  *  - Settings#simpleThemeId() - Simple theme (0 = light, 1 = dark).
  *  - Settings#editorGeometry() - Pack editor window geometry.
  *  - Settings#keyboardVisible() - Whether to show the virtual keyboard.
+ *  - Settings#recentPacks() - Recently opened custom packs (most recent first), which are preloaded at startup (see PackRegistry).
  */
 class CORE_LIB_EXPORT Settings
 {
@@ -215,6 +216,10 @@ class CORE_LIB_EXPORT Settings
 		static bool keyboardVisible(void);
 		static bool containsKeyboardVisible(void);
 		static void setKeyboardVisible(bool value);
+		// recentPacks
+		static QStringList recentPacks(void);
+		static bool containsRecentPacks(void);
+		static void setRecentPacks(QStringList value);
 
 	protected:
 		static QVariant get(QString key, QVariant defaultValue);
@@ -30,8 +30,8 @@
 #include <QObject>
 #include <QString>
 #include <QVector>
-#include "FileUtils.h"
-#include "Settings.h"
+#include <QStringList>
+#include "Mistake.h"
 
 /*! \brief The StringUtils class contains functions related to strings. */
 class CORE_LIB_EXPORT StringUtils
@@ -42,17 +42,38 @@ class CORE_LIB_EXPORT StringUtils
 		static QString wordAt(QString str, int index);
 		static QList<QVariant> longestCommonSubsequence(QList<QVariant> source, QList<QVariant> target);
 		static QString longestCommonSubsequence(QString source, QString target);
-		static QList<QVariantMap> compareLists(QList<QVariant> source, QList<QVariant> target, QVector<QPair<QString, int>> *recordedCharacters = nullptr, int *hits = nullptr, int *inputPos = nullptr);
-		static QList<QVariantMap> compareStrings(QString source, QString target, QVector<QPair<QString, int>> *recordedCharacters = nullptr, int *hits = nullptr, int *inputPos = nullptr);
-		static QList<QVariantMap> findMistakes(QString exerciseText, QString input, QVector<QPair<QString, int>> recordedCharacters, int *totalHits = nullptr, QStringList *errorWords = nullptr);
-		static QList<QVariantMap> validateExercise(QString exerciseText, QString inputText, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, int *mistakeCount, QStringList *errorWords = nullptr, bool timed = false, int timeSecs = 0);
-		static QString addMistakes(QString exerciseText, QList<QVariantMap> *recordedMistakes);
+		static MistakeList compareLists(QList<QVariant> source, QList<QVariant> target, QVector<QPair<QString, int>> *recordedCharacters = nullptr, int *hits = nullptr, int *inputPos = nullptr);
+		static MistakeList compareStrings(QString source, QString target, QVector<QPair<QString, int>> *recordedCharacters = nullptr, int *hits = nullptr, int *inputPos = nullptr);
+		static MistakeList findMistakes(QString exerciseText, QString input, QVector<QPair<QString, int>> recordedCharacters, int *totalHits = nullptr, QStringList *errorWords = nullptr);
+		static MistakeList validateExercise(QString exerciseText, QString inputText, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, int *mistakeCount, QStringList *errorWords = nullptr, bool timed = false, int timeSecs = 0);
+		static MistakeList validateExercise(QString exerciseText, QString inputText, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, int *mistakeCount, QStringList *errorWords, bool timed, int timeSecs, int mistakeChars, int *bandWidth = nullptr);
+		static QString addMistakes(QString exerciseText, MistakeList *recordedMistakes);
+		static int alignPrefix(QString text, QString input, int *bandWidth = nullptr);
+		static const int timedCandidateLimit = 8;
 
 	private:
+		struct TimedAttempt
+		{
+				MistakeList mistakes;
+				int totalHits = 0;
+				QStringList errorWords;
+		};
+
+		static const qint64 lcsTableLimit = 4194304;
+		static const int bandedAlignmentThreshold = 1024;
+		static const int minAlignmentBand = 32;
+		static void lcsSymbols(const QList<QVariant> &source, const QList<QVariant> &target, QVector<int> *sourceIds, QVector<int> *targetIds);
+		static int lcsLen(const QVector<int> &source, const QVector<int> &target);
+		static QVector<int> lcsIndices(const QVector<int> &source, const QVector<int> &target);
+		static QVector<int> lcsIndices(const QString &source, const QString &target);
+		static QVector<int> lcsIndicesMyers(const QVector<int> &source, const QVector<int> &target);
 		static int lcsLen(QList<QVariant> source, QList<QVariant> target);
-		static int lcsLen(QList<QVariant> source, QList<QVariant> target, QMap<int, QMap<int, int>> *lcsTable);
-		static QStringList splitWordsByPunct(QStringList source);
-		static QMap<int, QVariantMap> generateDiffList(QStringList *sourceWords, QStringList *targetWords, QList<int> *mergeList = nullptr);
+		static MistakeList findMistakes(QString exerciseText, QString input, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, QStringList *errorWords, int mistakeChars);
+		static QVector<int> alignPrefixDistances(const QString &text, const QString &input, int *bandWidth = nullptr);
+		static QVector<int> alignPrefixDistancesBanded(const QString &text, const QString &input, int band);
+		static QVector<int> alignPrefixes(const QString &text, const QString &input, int limit, int *bandWidth = nullptr);
+		static QMap<int, Mistake> generateDiffList(QStringList *sourceWords, QStringList *targetWords);
+		friend class StringUtilsTest;
 };
 
 #endif // STRINGUTILS_H
@@ -0,0 +1,102 @@
+/*
+ * TokenTable.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOKENTABLE_H
+#define TOKENTABLE_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*!
+ * \brief The TokenTable class splits a text into words and tokens once, so that they can be used many times.
+ *
+ * Words are separated by spaces and new lines. There's an empty word between 2 separators next to each other,
+ * so the text has (number of separators + 1) words.\n
+ * Every word is split into tokens. A token is either a sequence of characters, which aren't punctuation marks,
+ * or a single punctuation mark.
+ *
+ * Words and tokens are stored as spans (start and length) in the text with the index of the line they belong to.
+ *
+ * Example usage:
+ * \code
+ * TokenTable table("Hello, world");
+ * for(int i = 0; i < table.wordCount(); i++)
+ *     printf("%s\n", qPrintable(table.wordText(i))); // "Hello,", "world"
+ * printf("%d\n", table.wordAt(8)); // 1
+ * \endcode
+ */
+class CORE_LIB_EXPORT TokenTable
+{
+	public:
+		enum TokenClass
+		{
+			Class_Word,
+			Class_Punct
+		};
+
+		struct Word
+		{
+				int start;
+				int length;
+				int line;
+				int firstToken;
+				int tokenCount;
+		};
+
+		struct Token
+		{
+				int start;
+				int length;
+				int line;
+				TokenClass tokenClass;
+		};
+
+		TokenTable(void);
+		explicit TokenTable(const QString text);
+		void setText(const QString text);
+		QString text(void) const;
+		int lineCount(void) const;
+		int wordCount(void) const;
+		Word word(int index) const;
+		QString wordText(int index) const;
+		int wordAt(int position) const;
+		int tokenCount(void) const;
+		Token token(int index) const;
+		QString tokenText(int index) const;
+		QStringList splitWordsByPunct(void) const;
+
+	private:
+		QString m_text;
+		QVector<Word> words;
+		QVector<Token> tokens;
+		int m_lineCount = 1;
+};
+
+Q_DECLARE_TYPEINFO(TokenTable::Word, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(TokenTable::Token, Q_PRIMITIVE_TYPE);
+
+#endif // TOKENTABLE_H
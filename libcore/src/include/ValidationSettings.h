@@ -0,0 +1,51 @@
+/*
+ * ValidationSettings.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VALIDATIONSETTINGS_H
+#define VALIDATIONSETTINGS_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QSettings>
+
+/*!
+ * \brief The ValidationSettings class contains the settings keys and default values used to validate exercises.
+ *
+ * Settings uses them in its getters and setters. Tools which don't run QApplication (such as open-typer-grade)
+ * can read the settings with the functions of this class, so they use the same rules as the application.
+ */
+class CORE_LIB_EXPORT ValidationSettings
+{
+	public:
+		static const QString errorPenaltyKey;
+		static const QString mistakeLimitKey;
+		static const QString mistakeCharsKey;
+		static const int defaultErrorPenalty = 10;
+		static const bool defaultMistakeLimit = true;
+		static const int defaultMistakeChars = 6;
+		static int errorPenalty(const QSettings &settings);
+		static int mistakeChars(const QSettings &settings);
+};
+
+#endif // VALIDATIONSETTINGS_H
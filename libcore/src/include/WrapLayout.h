@@ -0,0 +1,77 @@
+/*
+ * WrapLayout.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WRAPLAYOUT_H
+#define WRAPLAYOUT_H
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+#include <QString>
+#include <QVector>
+
+/*!
+ * \brief The WrapLayout class stores line breaks of wrapped exercise text.
+ *
+ * The text is wrapped (see ConfigParser#initExercise()) and the line breaks are found only when the text or line length changes.
+ * Lines can then be read without going through the whole text again.
+ *
+ * The text can be followed by a repeated text (see setRepeatedText()), which is used in timed exercises.
+ * The repeated text isn't stored repeatedly, its lines are computed from the line breaks of one copy.
+ * \code
+ * WrapLayout layout;
+ * layout.setText(text, ConfigParser::defaultLineLength);
+ * QString currentLine = layout.line(0);
+ * QString remainingText = layout.window(1);
+ * \endcode
+ */
+class CORE_LIB_EXPORT WrapLayout
+{
+	public:
+		void setText(const QString text, int lineLength);
+		void setWrappedText(const QString text);
+		void setRepeatedText(const QString text, int count);
+		QString text(void);
+		int length(void);
+		int lineCount(void);
+		int lineStart(int index);
+		int lineLength(int index);
+		QString line(int index);
+		QString window(int firstLine, int maxLines = -1);
+
+	private:
+		QString sourceText;
+		int sourceLineLength = -1;
+		bool sourceWrapped = false;
+		QString wrappedText;
+		QVector<int> lineBreaks;
+		QString repeatedText;
+		QVector<int> repeatedLineBreaks;
+		int repeatCount = 0;
+		static QVector<int> findLineBreaks(const QString &text);
+		int lineBreakCount(void);
+		int lineBreak(int index);
+		QString mid(int position, int n);
+};
+
+#endif // WRAPLAYOUT_H
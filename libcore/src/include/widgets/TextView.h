@@ -25,6 +25,7 @@
 #include <QTextEdit>
 #include <QWheelEvent>
 #include <QLayout>
+#include <QHash>
 
 #if defined CORE_SHARED_LIB
 #define CORE_LIB_EXPORT Q_DECL_EXPORT
@@ -35,7 +36,8 @@
 /*!
  * \brief The TextView class is a QTextEdit used to display text.
  *
- * It contains modifications that ignore mouse wheel events and make the widget resize using fixed size according to the text document size.
+ * It contains modifications that ignore mouse wheel events and make the widget resize using fixed size according to the text document size.\n
+ * With a fixed-pitch font, the size can be computed from font metrics instead of the document layout (see setFixedPitchSizing()).
  */
 class CORE_LIB_EXPORT TextView : public QTextEdit
 {
@@ -46,9 +48,21 @@ class CORE_LIB_EXPORT TextView : public QTextEdit
 		void setHorizontalAdjust(bool value);
 		void setVerticalAdjust(bool value);
 		void toggleScrolling(bool enabled);
+		void setFixedPitchSizing(bool value);
 
 	private:
+		struct FontMetrics
+		{
+				qreal advance = 0;
+				qreal lineSpacing = 0;
+				bool fixedPitch = false;
+		};
+
+		static QHash<QString, FontMetrics> metricsCache;
+		static FontMetrics cachedMetrics(const QFont &font);
+		QSizeF fixedPitchSize(const FontMetrics &metrics);
 		bool horizontalAdjust = true, verticalAdjust = true;
+		bool fixedPitchSizing = false;
 		bool scrollingEnabled = true;
 
 	private slots:
@@ -0,0 +1,110 @@
+/*
+ * TypingSurface.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TYPINGSURFACE_H
+#define TYPINGSURFACE_H
+
+#include <QWidget>
+#include <QStaticText>
+#include <QVector>
+#include <QPair>
+#include <QBasicTimer>
+
+#if defined CORE_SHARED_LIB
+#define CORE_LIB_EXPORT Q_DECL_EXPORT
+#else
+#define CORE_LIB_EXPORT Q_DECL_IMPORT
+#endif
+
+/*!
+ * \brief The TypingSurface class paints typed text with underlined mistakes and their corrections.
+ *
+ * Each line (see Line) has a row of corrections and a row of typed text below it. Both rows and the underlines
+ * are painted from the same model, so they're aligned without stacking text widgets.
+ * The font must be monospace, positions of underlines, mistakes and the cursor are columns.\n
+ * While typing, the row of corrections can be hidden (see setCorrectionsVisible()) and the text from Line#mistakeColumn
+ * (a wrong character which hasn't been deleted yet) is painted with the correction color.
+ * The cursor is painted when the widget has focus (see setCursorPosition()).\n
+ * Text of each line is laid out once and cached in QStaticText objects. Only the lines in the exposed rectangle
+ * are painted and setLines() repaints only the lines which have changed, so a long text in a QScrollArea
+ * doesn't make painting slower.
+ *
+ * Example usage:
+ * \code
+ * TypingSurface::Line line;
+ * line.corrections = "    h";
+ * line.text = "The gouse";
+ * line.underlines += QPair<int, int>(4, 1);
+ * surface->setLines({ line });
+ * \endcode
+ */
+class CORE_LIB_EXPORT TypingSurface : public QWidget
+{
+		Q_OBJECT
+	public:
+		struct Line
+		{
+				QString text;
+				QString corrections;
+				QVector<QPair<int, int>> underlines; // column and length
+				int mistakeColumn = -1;
+				bool operator==(const Line &other) const;
+		};
+
+		explicit TypingSurface(QWidget *parent = nullptr);
+		void setLines(const QVector<Line> lines);
+		QVector<Line> lines(void);
+		void setText(const QString text);
+		void setCorrectionsVisible(bool visible);
+		void setCursorPosition(int line, int column);
+		QRect cursorRect(void) const;
+		void setTextFont(const QFont font);
+		void setCorrectionFont(const QFont font);
+		void setTextColor(const QColor color);
+		void setCorrectionColor(const QColor color);
+		QSize sizeHint(void) const;
+		static const int margin = 4;
+
+	protected:
+		void paintEvent(QPaintEvent *event);
+		void focusInEvent(QFocusEvent *event);
+		void focusOutEvent(QFocusEvent *event);
+		void timerEvent(QTimerEvent *event);
+
+	private:
+		QVector<Line> m_lines;
+		QVector<QStaticText> textCache, mistakeCache, correctionCache;
+		QFont textFont, correctionFont;
+		QColor textColor, correctionColor;
+		qreal charWidth = 0;
+		int correctionHeight = 0, textHeight = 0, textAscent = 0, underlinePos = 0;
+		int maxColumns = 0;
+		bool correctionsVisible = true;
+		int cursorLine = -1, cursorColumn = 0;
+		bool cursorShown = false;
+		QBasicTimer cursorTimer;
+		void updateMetrics(void);
+		void restartCursorBlinking(void);
+		void updateCache(int index);
+		int lineHeight(void) const;
+		QRect lineRect(int index) const;
+};
+
+#endif // TYPINGSURFACE_H
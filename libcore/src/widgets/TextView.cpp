@@ -18,12 +18,20 @@
  * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <QTextBlock>
+#include <QFontMetricsF>
+#include <QFontInfo>
 #include "widgets/TextView.h"
 
+QHash<QString, TextView::FontMetrics> TextView::metricsCache;
+
 /*! Constructs TextView. */
 TextView::TextView(QWidget *parent) :
 	QTextEdit(parent)
 {
+	// The text is only displayed, so there's nothing to undo
+	document()->setUndoRedoEnabled(false);
 	connect(this, &TextView::textChanged, this, &TextView::updateWidgetSize);
 }
 
@@ -48,33 +56,84 @@ void TextView::toggleScrolling(bool enabled)
 	scrollingEnabled = enabled;
 }
 
+/*!
+ * Toggles computing the widget size from font metrics and the number of lines and columns.\n
+ * This doesn't need the document layout, but it works only with a fixed-pitch font and plain text,
+ * where each line is a separate block. If the font isn't fixed-pitch, the document size is used.
+ */
+void TextView::setFixedPitchSizing(bool value)
+{
+	fixedPitchSizing = value;
+	updateWidgetSize();
+}
+
 /*! Sets widget fixed size according to the text document. */
 void TextView::updateWidgetSize(void)
 {
-	QTextDocument *targetDocument;
-	if(toPlainText() == "")
+	QSizeF size;
+	FontMetrics metrics;
+	if(fixedPitchSizing)
+		metrics = cachedMetrics(document()->defaultFont());
+	if(fixedPitchSizing && metrics.fixedPitch)
+		size = fixedPitchSize(metrics);
+	else if(document()->isEmpty())
 	{
-		targetDocument = document()->clone(this);
+		QTextDocument *targetDocument = document()->clone(this);
 		targetDocument->setPlainText("A");
+		size = targetDocument->size();
+		targetDocument->deleteLater();
 	}
 	else
-		targetDocument = document();
+		size = document()->size();
 	if(horizontalAdjust)
-		setFixedWidth(targetDocument->size().width());
+		setFixedWidth(size.width());
 	else
 	{
 		setMinimumWidth(0);
 		setMaximumWidth(QWIDGETSIZE_MAX);
 	}
 	if(verticalAdjust)
-		setFixedHeight(targetDocument->size().height());
+		setFixedHeight(size.height());
 	else
 	{
 		setMinimumHeight(0);
 		setMaximumHeight(QWIDGETSIZE_MAX);
 	}
-	if(toPlainText() == "")
-		targetDocument->deleteLater();
+}
+
+/*! Returns the size of the document computed from the font metrics. An empty document has the size of one character. */
+QSizeF TextView::fixedPitchSize(const FontMetrics &metrics)
+{
+	int lines = 0, columns = 1;
+	for(QTextBlock block = document()->begin(); block.isValid(); block = block.next())
+	{
+		lines++;
+		columns = std::max(columns, block.length() - 1);
+	}
+	lines = std::max(1, lines);
+	qreal margin = document()->documentMargin();
+	// The layout adds 1 pixel for the cursor
+	return QSizeF(columns * metrics.advance + margin * 2 + 1, lines * metrics.lineSpacing + margin * 2);
+}
+
+/*! Returns the metrics of the font. They're cached, so zooming and changing the theme reuses them. */
+TextView::FontMetrics TextView::cachedMetrics(const QFont &font)
+{
+	QString key = font.key();
+	auto cached = metricsCache.constFind(key);
+	if(cached != metricsCache.constEnd())
+		return cached.value();
+	QFontMetricsF fontMetrics(font);
+	FontMetrics metrics;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+	metrics.advance = fontMetrics.horizontalAdvance('A');
+#else
+	metrics.advance = fontMetrics.width('A');
+#endif
+	metrics.lineSpacing = fontMetrics.lineSpacing();
+	metrics.fixedPitch = QFontInfo(font).fixedPitch();
+	metricsCache.insert(key, metrics);
+	return metrics;
 }
 
 /*! Overrides QTextEdit#changeEvent(). */
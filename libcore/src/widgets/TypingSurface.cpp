@@ -0,0 +1,288 @@
+/*
+ * TypingSurface.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QFontMetricsF>
+#include <QtMath>
+#include <QGuiApplication>
+#include <QStyleHints>
+#include "widgets/TypingSurface.h"
+
+/*! Returns true if the lines are equal. */
+bool TypingSurface::Line::operator==(const Line &other) const
+{
+	return (text == other.text) && (corrections == other.corrections) && (underlines == other.underlines) && (mistakeColumn == other.mistakeColumn);
+}
+
+/*! Constructs TypingSurface. */
+TypingSurface::TypingSurface(QWidget *parent) :
+	QWidget(parent),
+	textFont(font()),
+	correctionFont(font()),
+	textColor(palette().color(QPalette::Text)),
+	correctionColor(Qt::red)
+{
+	setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+	updateMetrics();
+}
+
+/*! Sets the lines. Only the lines which have changed are laid out and painted again. */
+void TypingSurface::setLines(const QVector<Line> lines)
+{
+	int oldCount = m_lines.count();
+	int oldMaxColumns = maxColumns;
+	m_lines.resize(lines.count());
+	textCache.resize(lines.count());
+	mistakeCache.resize(lines.count());
+	correctionCache.resize(lines.count());
+	maxColumns = 0;
+	for(int i = 0; i < lines.count(); i++)
+	{
+		if((i >= oldCount) || !(m_lines[i] == lines[i]))
+		{
+			m_lines[i] = lines[i];
+			updateCache(i);
+			update(lineRect(i));
+		}
+		maxColumns = std::max(maxColumns, (int) std::max(lines[i].text.count(), lines[i].corrections.count()));
+		for(int j = 0; j < lines[i].underlines.count(); j++)
+			maxColumns = std::max(maxColumns, lines[i].underlines[j].first + lines[i].underlines[j].second);
+	}
+	// Removed lines
+	for(int i = lines.count(); i < oldCount; i++)
+		update(lineRect(i));
+	if((lines.count() != oldCount) || (maxColumns != oldMaxColumns))
+		updateGeometry();
+}
+
+/*! Returns the lines. */
+QVector<TypingSurface::Line> TypingSurface::lines(void)
+{
+	return m_lines;
+}
+
+/*! Sets lines of plain text without mistakes and corrections. */
+void TypingSurface::setText(const QString text)
+{
+	QVector<Line> newLines;
+	const QStringList textLines = text.split('\n');
+	for(int i = 0; i < textLines.count(); i++)
+	{
+		Line line;
+		line.text = textLines[i];
+		newLines += line;
+	}
+	setLines(newLines);
+}
+
+/*! Shows or hides the row of corrections above each line. */
+void TypingSurface::setCorrectionsVisible(bool visible)
+{
+	if(visible == correctionsVisible)
+		return;
+	correctionsVisible = visible;
+	updateGeometry();
+	update();
+}
+
+/*!
+ * Moves the cursor to the column of the line.\n
+ * Use -1 as line to remove the cursor.
+ */
+void TypingSurface::setCursorPosition(int line, int column)
+{
+	if((line == cursorLine) && (column == cursorColumn))
+		return;
+	update(cursorRect());
+	cursorLine = line;
+	cursorColumn = column;
+	restartCursorBlinking();
+}
+
+/*! Returns the rectangle of the cursor. */
+QRect TypingSurface::cursorRect(void) const
+{
+	if(cursorLine < 0)
+		return QRect();
+	int top = margin + cursorLine * lineHeight() + (correctionsVisible ? correctionHeight : 0);
+	return QRect(margin + qRound(cursorColumn * charWidth), top, 1, textHeight);
+}
+
+/*! Sets the font of the typed text. */
+void TypingSurface::setTextFont(const QFont font)
+{
+	textFont = font;
+	updateMetrics();
+}
+
+/*! Sets the font of the corrections. */
+void TypingSurface::setCorrectionFont(const QFont font)
+{
+	correctionFont = font;
+	updateMetrics();
+}
+
+/*! Sets the color of the typed text. */
+void TypingSurface::setTextColor(const QColor color)
+{
+	textColor = color;
+	update();
+}
+
+/*! Sets the color of the corrections and underlines. */
+void TypingSurface::setCorrectionColor(const QColor color)
+{
+	correctionColor = color;
+	update();
+}
+
+/*! Returns the size of all lines. */
+QSize TypingSurface::sizeHint(void) const
+{
+	// The cursor can be after the last column
+	return QSize(qCeil(maxColumns * charWidth) + margin * 2 + 1, lineHeight() * m_lines.count() + margin * 2);
+}
+
+/*! Paints the lines in the exposed rectangle. */
+void TypingSurface::paintEvent(QPaintEvent *event)
+{
+	QPainter painter(this);
+	QRect rect = event->rect();
+	if(cursorShown && rect.intersects(cursorRect()))
+		painter.fillRect(cursorRect(), textColor);
+	if(m_lines.isEmpty())
+		return;
+	int first = std::max(0, (rect.top() - margin) / lineHeight());
+	int last = std::min(m_lines.count() - 1, (rect.bottom() - margin) / lineHeight());
+	for(int i = first; i <= last; i++)
+	{
+		int top = margin + i * lineHeight();
+		if(correctionsVisible)
+		{
+			painter.setPen(correctionColor);
+			painter.setFont(correctionFont);
+			painter.drawStaticText(margin, top, correctionCache[i]);
+			top += correctionHeight;
+		}
+		painter.setPen(textColor);
+		painter.setFont(textFont);
+		painter.drawStaticText(margin, top, textCache[i]);
+		if(m_lines[i].mistakeColumn >= 0)
+		{
+			painter.setPen(correctionColor);
+			painter.drawStaticText(QPointF(margin + m_lines[i].mistakeColumn * charWidth, top), mistakeCache[i]);
+		}
+		const QVector<QPair<int, int>> &underlines = m_lines[i].underlines;
+		if(underlines.isEmpty())
+			continue;
+		painter.setPen(correctionColor);
+		int y = top + textAscent + underlinePos;
+		for(int j = 0; j < underlines.count(); j++)
+			painter.drawLine(QPointF(margin + underlines[j].first * charWidth, y), QPointF(margin + (underlines[j].first + underlines[j].second) * charWidth, y));
+	}
+}
+
+/*! Shows the cursor and starts blinking if the widget has focus. */
+void TypingSurface::focusInEvent(QFocusEvent *event)
+{
+	restartCursorBlinking();
+	QWidget::focusInEvent(event);
+}
+
+/*! Hides the cursor. */
+void TypingSurface::focusOutEvent(QFocusEvent *event)
+{
+	restartCursorBlinking();
+	QWidget::focusOutEvent(event);
+}
+
+/*! Toggles the cursor. */
+void TypingSurface::timerEvent(QTimerEvent *event)
+{
+	if(event->timerId() == cursorTimer.timerId())
+	{
+		cursorShown = !cursorShown;
+		update(cursorRect());
+	}
+	else
+		QWidget::timerEvent(event);
+}
+
+/*! Shows the cursor (if the widget has focus) and restarts the blink timer, so the cursor doesn't disappear while typing. */
+void TypingSurface::restartCursorBlinking(void)
+{
+	cursorShown = hasFocus() && (cursorLine >= 0);
+	int flashTime = QGuiApplication::styleHints()->cursorFlashTime();
+	if(cursorShown && (flashTime > 0))
+		cursorTimer.start(flashTime / 2, this);
+	else
+		cursorTimer.stop();
+	update(cursorRect());
+}
+
+/*! Updates font metrics and lays out all lines again. */
+void TypingSurface::updateMetrics(void)
+{
+	QFontMetricsF textMetrics(textFont);
+	QFontMetricsF correctionMetrics(correctionFont);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+	charWidth = textMetrics.horizontalAdvance(' ');
+#else
+	charWidth = textMetrics.width(' ');
+#endif
+	correctionHeight = qCeil(correctionMetrics.lineSpacing());
+	textHeight = qCeil(textMetrics.lineSpacing());
+	textAscent = qRound(textMetrics.ascent());
+	underlinePos = std::max(1, qRound(textMetrics.underlinePos()));
+	for(int i = 0; i < m_lines.count(); i++)
+		updateCache(i);
+	updateGeometry();
+	update();
+}
+
+/*! Lays out the text of the line. */
+void TypingSurface::updateCache(int index)
+{
+	const Line &line = m_lines[index];
+	bool mistake = (line.mistakeColumn >= 0);
+	textCache[index].setTextFormat(Qt::PlainText);
+	textCache[index].setText(mistake ? line.text.left(line.mistakeColumn) : line.text);
+	textCache[index].prepare(QTransform(), textFont);
+	mistakeCache[index].setTextFormat(Qt::PlainText);
+	mistakeCache[index].setText(mistake ? line.text.mid(line.mistakeColumn) : QString());
+	mistakeCache[index].prepare(QTransform(), textFont);
+	correctionCache[index].setTextFormat(Qt::PlainText);
+	correctionCache[index].setText(line.corrections);
+	correctionCache[index].prepare(QTransform(), correctionFont);
+}
+
+/*! Returns the height of a line (the row of corrections, if it's visible, and the row of typed text). */
+int TypingSurface::lineHeight(void) const
+{
+	return std::max(1, (correctionsVisible ? correctionHeight : 0) + textHeight);
+}
+
+/*! Returns the rectangle of the line. */
+QRect TypingSurface::lineRect(int index) const
+{
+	return QRect(0, margin + index * lineHeight(), width(), lineHeight());
+}
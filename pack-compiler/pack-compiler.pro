@@ -0,0 +1,14 @@
+QT += core widgets network websockets charts
+CONFIG += console
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = pack-compiler
+DESTDIR = $$_PRO_FILE_PWD_/..
+
+INCLUDEPATH += ../libcore/src/include
+
+LIBS += -L$$_PRO_FILE_PWD_/.. -lopentyper-core
+
+SOURCES += \
+    src/main.cpp
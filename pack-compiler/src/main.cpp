@@ -0,0 +1,55 @@
+/*
+ * main.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QTextStream>
+#include "ConfigParser.h"
+#include "CompiledPack.h"
+
+/*!
+ * Converts a pack file to the compiled pack format.\n
+ * Usage: pack-compiler <input pack> <output file>
+ * \see CompiledPack
+ */
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	QTextStream err(stderr);
+	QStringList args = a.arguments();
+	if(args.count() != 3)
+	{
+		err << "Usage: pack-compiler <input pack> <output file>\n";
+		return 1;
+	}
+	ConfigParser parser;
+	if(!parser.open(args[1]))
+	{
+		err << "Failed to open " << args[1] << "\n";
+		return 2;
+	}
+	QFile outFile(args[2]);
+	if(!outFile.open(QIODevice::WriteOnly))
+	{
+		err << "Failed to write " << args[2] << "\n";
+		return 3;
+	}
+	outFile.write(CompiledPack::compile(&parser));
+	return 0;
+}
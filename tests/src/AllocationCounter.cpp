@@ -0,0 +1,84 @@
+/*
+ * AllocationCounter.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include "AllocationCounter.h"
+
+static std::atomic<bool> counting(false);
+static std::atomic<qint64> allocationCount(0);
+
+/*! Returns true if allocations can be counted. */
+bool AllocationCounter::isSupported(void)
+{
+#ifdef __GLIBC__
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*! Starts counting allocations (in all threads). */
+void AllocationCounter::start(void)
+{
+	allocationCount = 0;
+	counting = true;
+}
+
+/*! Stops counting and returns the number of allocations since start(). */
+qint64 AllocationCounter::stop(void)
+{
+	counting = false;
+	return allocationCount;
+}
+
+/*! Counts an allocation. This is called by the allocation functions and it must not allocate. */
+void AllocationCounter::add(void)
+{
+	if(counting.load(std::memory_order_relaxed))
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+#ifdef __GLIBC__
+extern "C"
+{
+	void *__libc_malloc(size_t size);
+	void *__libc_calloc(size_t count, size_t size);
+	void *__libc_realloc(void *ptr, size_t size);
+
+	void *malloc(size_t size) __THROW
+	{
+		AllocationCounter::add();
+		return __libc_malloc(size);
+	}
+
+	void *calloc(size_t count, size_t size) __THROW
+	{
+		AllocationCounter::add();
+		return __libc_calloc(count, size);
+	}
+
+	void *realloc(void *ptr, size_t size) __THROW
+	{
+		AllocationCounter::add();
+		return __libc_realloc(ptr, size);
+	}
+}
+#endif // __GLIBC__
@@ -0,0 +1,98 @@
+/*
+ * BackgroundValidatorTest.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BackgroundValidatorTest.h"
+
+/*! Returns the mistakes as a list of variant maps, so that they can be compared. */
+QVariantList BackgroundValidatorTest::mistakeList(const MistakeList &mistakes)
+{
+	QVariantList out;
+	for(int i = 0; i < mistakes.count(); i++)
+		out += mistakes[i].toVariantMap();
+	return out;
+}
+
+void BackgroundValidatorTest::sameAsBatch_data(void)
+{
+	QTest::addColumn<QString>("exerciseText");
+	QTest::addColumn<QString>("typedText");
+	QTest::addColumn<int>("mistakeChars");
+	QTest::addColumn<bool>("timed");
+	QTest::addColumn<int>("timeSecs");
+	QString text = "The quick brown fox jumps over the lazy dog.\nPack my box with five dozen liquor jugs.";
+	QTest::newRow("correct") << text << text << 6 << false << 0;
+	QTest::newRow("changed words") << text << "The quikc brown fox jumsp over teh lazy dog.\nPack my box with five dozen liquor jugs." << 6 << false << 0;
+	QTest::newRow("added and deleted words") << text << "The quick quick brown fox over the lazy dog.\nPack my box with five liquor jugs." << 6 << false << 0;
+	QTest::newRow("deleted space") << text << "The quickbrown fox jumps overthe lazy dog.\nPack my box with five dozen liquor jugs." << 6 << false << 0;
+	QTest::newRow("backspace") << text << "The quik\bck brown fox jumps ovr\b\ber the lazy dog.\nPack my box with five dozen liquor jugs." << 6 << false << 0;
+	QTest::newRow("mistake limit") << text << "Teh qiuck bronw fox jumps over the lazy dog.\nPack my box with five dozen liquor jugs." << 3 << false << 0;
+	QTest::newRow("no mistake limit") << text << "Teh qiuck bronw fox jumps over the lazy dog.\nPack my box with five dozen liquor jugs." << 0 << false << 0;
+	QTest::newRow("unfinished") << text << "The quick brown fox ju" << 6 << false << 0;
+	QTest::newRow("timed") << "one two three\n" << "one two three one tow three one two thre" << 6 << true << 5;
+}
+
+void BackgroundValidatorTest::sameAsBatch(void)
+{
+	QFETCH(QString, exerciseText);
+	QFETCH(QString, typedText);
+	QFETCH(int, mistakeChars);
+	QFETCH(bool, timed);
+	QFETCH(int, timeSecs);
+	BackgroundValidator validator;
+	validator.start(exerciseText, mistakeChars, timed, timeSecs);
+	QString input;
+	QVector<QPair<QString, int>> recordedCharacters;
+	for(int i = 0; i < typedText.count(); i++)
+	{
+		if(typedText[i] == '\b')
+		{
+			input.chop(1);
+			recordedCharacters.removeLast();
+			validator.removeCharacter();
+		}
+		else
+		{
+			QString character(typedText[i]);
+			int hits = typedText[i].isUpper() ? 2 : 1;
+			input += character;
+			recordedCharacters += QPair<QString, int>(character, hits);
+			validator.addCharacter(character, hits);
+		}
+		// Let the validator start the pending validation
+		QCoreApplication::processEvents();
+	}
+	// The last validation might still be running or it might not use the whole input
+	BackgroundValidator::Result immediateResult = validator.result().result();
+	// Wait until the last background validation uses the whole input, so that its result is reused
+	QTRY_VERIFY(validator.hasResult());
+	BackgroundValidator::Result result = validator.result().result();
+	BackgroundValidator::Result batch = BackgroundValidator::validate(exerciseText, input, recordedCharacters, mistakeChars, timed, timeSecs);
+	int totalHits = 0, mistakeCount = 0;
+	QStringList errorWords;
+	MistakeList mistakes = StringUtils::validateExercise(exerciseText, input, recordedCharacters, &totalHits, &mistakeCount, &errorWords, timed, timeSecs, mistakeChars);
+	QCOMPARE(mistakeList(result.mistakes), mistakeList(mistakes));
+	QCOMPARE(result.totalHits, totalHits);
+	QCOMPARE(result.mistakeCount, mistakeCount);
+	QCOMPARE(result.errorWords, errorWords);
+	QCOMPARE(mistakeList(immediateResult.mistakes), mistakeList(mistakes));
+	QCOMPARE(immediateResult.totalHits, totalHits);
+	QCOMPARE(mistakeList(batch.mistakes), mistakeList(mistakes));
+	QCOMPARE(batch.mistakeCount, mistakeCount);
+}
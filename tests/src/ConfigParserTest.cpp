@@ -0,0 +1,294 @@
+/*
+ * ConfigParserTest.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "ConfigParserTest.h"
+#include "LegacyPackReader.h"
+
+/*! Creates the large pack. */
+void ConfigParserTest::initTestCase(void)
+{
+	QVERIFY(tempDir.isValid());
+	largePackFileName = tempDir.filePath("large.typer");
+	QFile file(largePackFileName);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+	qint64 size = 0;
+	int lesson = 0;
+	while(size < largePackSize)
+	{
+		lesson++;
+		for(int sublesson = 1; sublesson <= 4; sublesson++)
+		{
+			for(int exercise = 1; exercise <= 100; exercise++)
+			{
+				QByteArray line = QString("%1.%2.%3:0,0;%4,%5 %6\n").arg(lesson).arg(sublesson).arg(exercise).arg(ConfigParser::defaultRepeatLimit).arg(ConfigParser::defaultLineLength).arg(exerciseRawText(lesson, sublesson, exercise)).toUtf8();
+				QCOMPARE(file.write(line), (qint64) line.size());
+				size += line.size();
+			}
+		}
+	}
+	lastLesson = lesson;
+	lastSublesson = 4;
+	lastExercise = 100;
+	lastRawText = exerciseRawText(lastLesson, lastSublesson, lastExercise);
+}
+
+void ConfigParserTest::parseExerciseLine_data(void)
+{
+	QTest::addColumn<QString>("line");
+	const QStringList lines = sampleLines();
+	for(int i = 0; i < lines.count(); i++)
+		QTest::newRow(lines[i].toUtf8().constData()) << lines[i];
+}
+
+/*! Checks that the single-pass tokenizer returns the same fields as the separate functions. */
+void ConfigParserTest::parseExerciseLine(void)
+{
+	QFETCH(QString, line);
+	ExerciseRecord record = ConfigParser::parseExerciseLine(line);
+	QString repeatConfig = LegacyPackReader::exerciseRepeatConfig(line);
+	QString attributes = LegacyPackReader::exerciseAttributes(line);
+	QCOMPARE(record.lesson, LegacyPackReader::exerciseID(line, 1));
+	QCOMPARE(record.sublesson, LegacyPackReader::exerciseID(line, 2));
+	QCOMPARE(record.exercise, LegacyPackReader::exerciseID(line, 3));
+	QCOMPARE(record.repeat, LegacyPackReader::exerciseRepeatBool(repeatConfig));
+	QCOMPARE(record.repeatType, LegacyPackReader::exerciseRepeatType(repeatConfig));
+	QCOMPARE(record.repeatLimit, LegacyPackReader::exerciseAttribute(attributes, 0).toInt());
+	QCOMPARE(record.lineLength, LegacyPackReader::exerciseAttribute(attributes, 1).toInt());
+	QCOMPARE(record.desc, LegacyPackReader::exerciseAttribute(attributes, 2));
+	QCOMPARE(ConfigParser::rawText(line, record), LegacyPackReader::exerciseRawText(line));
+}
+
+void ConfigParserTest::parseLines_data(void)
+{
+	QTest::addColumn<bool>("legacy");
+	QTest::newRow("legacy") << true;
+	QTest::newRow("tokenizer") << false;
+}
+
+/*!
+ * Measures the time it takes to read all fields of 10000 exercise lines.\n
+ * The throughput in lines/s is 10000 divided by the time of one iteration.
+ */
+void ConfigParserTest::parseLines(void)
+{
+	QFETCH(bool, legacy);
+	const QStringList samples = sampleLines();
+	QStringList lines;
+	while(lines.count() < 10000)
+		lines += samples;
+	lines = lines.mid(0, 10000);
+	int checksum = 0;
+	QBENCHMARK
+	{
+		checksum = 0;
+		for(int i = 0; i < lines.count(); i++)
+		{
+			const QString &line = lines[i];
+			if(legacy)
+			{
+				QString repeatConfig = LegacyPackReader::exerciseRepeatConfig(line);
+				QString attributes = LegacyPackReader::exerciseAttributes(line);
+				checksum += LegacyPackReader::exerciseID(line, 1) + LegacyPackReader::exerciseID(line, 2) + LegacyPackReader::exerciseID(line, 3);
+				checksum += LegacyPackReader::exerciseRepeatBool(repeatConfig) + LegacyPackReader::exerciseRepeatType(repeatConfig).count();
+				checksum += LegacyPackReader::exerciseAttribute(attributes, 0).toInt() + LegacyPackReader::exerciseAttribute(attributes, 1).toInt();
+				checksum += LegacyPackReader::exerciseAttribute(attributes, 2).count() + LegacyPackReader::exerciseRawText(line).count();
+			}
+			else
+			{
+				ExerciseRecord record = ConfigParser::parseExerciseLine(line);
+				checksum += record.lesson + record.sublesson + record.exercise;
+				checksum += record.repeat + record.repeatType.count();
+				checksum += record.repeatLimit + record.lineLength;
+				checksum += record.desc.count() + ConfigParser::rawText(line, record).count();
+			}
+		}
+	}
+	QVERIFY(checksum > 0);
+}
+
+/*! Checks the text cache counters and that the cache is invalidated when the pack changes. */
+void ConfigParserTest::textCache(void)
+{
+	ConfigParser parser;
+	QByteArray content = "1.1.1:1,w;20,60 ab cd\n";
+	parser.loadToBuffer(content);
+	QString text = "ab cd ab cd ab cd ab";
+	QCOMPARE(parser.exerciseText(1, 1, 1), text);
+	QCOMPARE(parser.textCacheHits(), 0);
+	QCOMPARE(parser.textCacheMisses(), 1);
+	QCOMPARE(parser.exerciseText(1, 1, 1), text);
+	QCOMPARE(parser.textCacheHits(), 1);
+	QCOMPARE(parser.textCacheMisses(), 1);
+	// The wrapped text is generated from the cached text
+	QString wrappedText = ConfigParser::initExercise(text, 10);
+	QCOMPARE(parser.wrappedExerciseText(1, 1, 1, 10), wrappedText);
+	QCOMPARE(parser.textCacheHits(), 2);
+	QCOMPARE(parser.textCacheMisses(), 2);
+	QCOMPARE(parser.wrappedExerciseText(1, 1, 1, 10), wrappedText);
+	QCOMPARE(parser.textCacheHits(), 3);
+	QCOMPARE(parser.textCacheMisses(), 2);
+	// Changes of the pack invalidate the cache
+	QVERIFY(parser.addExercise(1, 1, 2, false, "0", ConfigParser::defaultRepeatLimit, ConfigParser::defaultLineLength, "", "ef"));
+	QCOMPARE(parser.exerciseText(1, 1, 1), text);
+	QCOMPARE(parser.textCacheMisses(), 3);
+	QCOMPARE(parser.exerciseText(1, 1, 2), QString("ef"));
+	QCOMPARE(parser.textCacheMisses(), 4);
+	parser.loadToBuffer(content);
+	QCOMPARE(parser.exerciseText(1, 1, 1), text);
+	QCOMPARE(parser.textCacheHits(), 3);
+	QCOMPARE(parser.textCacheMisses(), 5);
+}
+
+void ConfigParserTest::largePackMemory_data(void)
+{
+	QTest::addColumn<bool>("mapped");
+	QTest::newRow("mapped") << true;
+	QTest::newRow("buffer") << false;
+}
+
+/*! Reports heap memory used by an opened large pack. */
+void ConfigParserTest::largePackMemory(void)
+{
+#ifdef __GLIBC__
+	QFETCH(bool, mapped);
+	qint64 oldUsage = heapUsage();
+	ConfigParser parser;
+	if(mapped)
+		QVERIFY(parser.open(largePackFileName));
+	else
+	{
+		QFile file(largePackFileName);
+		QVERIFY(file.open(QIODevice::ReadOnly));
+		parser.loadToBuffer(file.readAll());
+	}
+	QCOMPARE(parser.exerciseRawText(lastLesson, lastSublesson, lastExercise), lastRawText);
+	QTest::setBenchmarkResult(heapUsage() - oldUsage, QTest::BytesAllocated);
+#else
+	QSKIP("Heap usage is available only with the GNU C library");
+#endif
+}
+
+void ConfigParserTest::largePackOpen_data(void)
+{
+	QTest::addColumn<QString>("reader");
+	QTest::newRow("legacy") << "legacy";
+	QTest::newRow("mapped") << "mapped";
+	QTest::newRow("buffer") << "buffer";
+}
+
+/*! Measures the time it takes to open the large pack and read its last exercise. */
+void ConfigParserTest::largePackOpen(void)
+{
+	QFETCH(QString, reader);
+	QString rawText;
+	QBENCHMARK
+	{
+		if(reader == "legacy")
+		{
+			QFile file(largePackFileName);
+			QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+			QString line = LegacyPackReader::lineOf(&file, lastLesson, lastSublesson, lastExercise);
+			rawText = line.mid(line.indexOf(' ') + 1);
+		}
+		else
+		{
+			ConfigParser parser;
+			if(reader == "mapped")
+				QVERIFY(parser.open(largePackFileName));
+			else
+			{
+				QFile file(largePackFileName);
+				QVERIFY(file.open(QIODevice::ReadOnly));
+				parser.loadToBuffer(file.readAll());
+			}
+			rawText = parser.exerciseRawText(lastLesson, lastSublesson, lastExercise);
+		}
+	}
+	QCOMPARE(rawText, lastRawText);
+}
+
+void ConfigParserTest::largePackQuery_data(void)
+{
+	QTest::addColumn<bool>("legacy");
+	QTest::newRow("legacy") << true;
+	QTest::newRow("mapped") << false;
+}
+
+/*! Measures the time it takes to read the last exercise of the opened large pack (for example when it's selected). */
+void ConfigParserTest::largePackQuery(void)
+{
+	QFETCH(bool, legacy);
+	QFile file(largePackFileName);
+	ConfigParser parser;
+	if(legacy)
+		QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+	else
+		QVERIFY(parser.open(largePackFileName));
+	QString rawText;
+	QBENCHMARK
+	{
+		if(legacy)
+		{
+			QString line = LegacyPackReader::lineOf(&file, lastLesson, lastSublesson, lastExercise);
+			rawText = line.mid(line.indexOf(' ') + 1);
+		}
+		else
+			rawText = parser.exerciseRawText(lastLesson, lastSublesson, lastExercise);
+	}
+	QCOMPARE(rawText, lastRawText);
+}
+
+/*! Returns exercise lines with all kinds of fields and escape sequences. */
+QStringList ConfigParserTest::sampleLines(void)
+{
+	QStringList out;
+	out += "1.1.1:1,0;128,60,dfjk fff jjj fff jjj ddd kkk dfjk";
+	out += "1.2.1:1,w;300,60 fff jjj ddd kkk dfjk jfkd";
+	out += "4.3.12:0,0;128,60 Text with a new line\\nand a backslash \\\\ inside.";
+	out += "10.4.7:1,0;256,65,%s\\,%r Mixed; punctuation, here.";
+	out += "25.1.100:0,0;1000,80 A longer sentence, which is typed by more advanced students in the last lessons of a pack.";
+	return out;
+}
+
+/*! Returns raw text of an exercise in the large pack. */
+QString ConfigParserTest::exerciseRawText(int lesson, int sublesson, int exercise)
+{
+	QString out = QString("lesson %1 sublesson %2 exercise %3").arg(lesson).arg(sublesson).arg(exercise);
+	while(out.count() < 200)
+		out += " the quick brown fox jumps over the lazy dog";
+	return out;
+}
+
+/*! Returns the number of bytes in use by the heap. */
+qint64 ConfigParserTest::heapUsage(void)
+{
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+	struct mallinfo2 info = mallinfo2();
+	return info.uordblks + info.hblkhd;
+#elif defined(__GLIBC__)
+	struct mallinfo info = mallinfo();
+	return (qint64) info.uordblks + info.hblkhd;
+#else
+	return 0;
+#endif
+}
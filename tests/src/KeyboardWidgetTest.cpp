@@ -0,0 +1,147 @@
+/*
+ * KeyboardWidgetTest.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KeyboardWidgetTest.h"
+
+void KeyboardWidgetTest::highlight_data(void)
+{
+	addKeyboardRows();
+}
+
+/*!
+ * Measures the time it takes to show a pressed and a released key (highlightKey() and dehighlightKey()).\n
+ * This includes painting the changed key.
+ */
+void KeyboardWidgetTest::highlight(void)
+{
+	QFETCH(bool, legacy);
+	if(legacy)
+		benchmarkHighlight<LegacyKeyboardWidget>();
+	else
+		benchmarkHighlight<KeyboardWidget>();
+}
+
+void KeyboardWidgetTest::construction_data(void)
+{
+	addKeyboardRows();
+}
+
+/*! Measures the time it takes to construct the keyboard widget. */
+void KeyboardWidgetTest::construction(void)
+{
+	QFETCH(bool, legacy);
+	if(legacy)
+		benchmarkConstruction<LegacyKeyboardWidget>();
+	else
+		benchmarkConstruction<KeyboardWidget>();
+}
+
+void KeyboardWidgetTest::objectCount_data(void)
+{
+	addKeyboardRows();
+}
+
+/*! Reports the number of objects the keyboard widget consists of (including the widget itself). */
+void KeyboardWidgetTest::objectCount(void)
+{
+	QFETCH(bool, legacy);
+	if(legacy)
+		benchmarkObjectCount<LegacyKeyboardWidget>();
+	else
+		benchmarkObjectCount<KeyboardWidget>();
+}
+
+void KeyboardWidgetTest::themeSwitch_data(void)
+{
+	addKeyboardRows();
+}
+
+/*!
+ * Measures the time it takes to switch between a light and a dark key color (2 theme switches).\n
+ * This includes painting the keyboard.
+ */
+void KeyboardWidgetTest::themeSwitch(void)
+{
+	QFETCH(bool, legacy);
+	if(legacy)
+		benchmarkThemeSwitch<LegacyKeyboardWidget>();
+	else
+		benchmarkThemeSwitch<KeyboardWidget>();
+}
+
+/*! Adds rows with both keyboard widgets. */
+void KeyboardWidgetTest::addKeyboardRows(void)
+{
+	QTest::addColumn<bool>("legacy");
+	QTest::newRow("legacy") << true;
+	QTest::newRow("current") << false;
+}
+
+template<typename Keyboard>
+void KeyboardWidgetTest::benchmarkHighlight(void)
+{
+	Keyboard keyboard;
+	keyboard.setKeyColor(QColor(255, 255, 255), QColor(0, 0, 0));
+	keyboard.show();
+	QVERIFY(QTest::qWaitForWindowExposed(&keyboard));
+	QCoreApplication::processEvents();
+	QBENCHMARK
+	{
+		keyboard.highlightKey(Qt::Key_Space);
+		QCoreApplication::processEvents();
+		keyboard.dehighlightKey(Qt::Key_Space);
+		QCoreApplication::processEvents();
+	}
+}
+
+template<typename Keyboard>
+void KeyboardWidgetTest::benchmarkConstruction(void)
+{
+	QBENCHMARK
+	{
+		Keyboard keyboard;
+		keyboard.setKeyColor(QColor(255, 255, 255), QColor(0, 0, 0));
+	}
+}
+
+template<typename Keyboard>
+void KeyboardWidgetTest::benchmarkObjectCount(void)
+{
+	Keyboard keyboard;
+	keyboard.setKeyColor(QColor(255, 255, 255), QColor(0, 0, 0));
+	QTest::setBenchmarkResult(keyboard.template findChildren<QObject *>().count() + 1, QTest::Events);
+}
+
+template<typename Keyboard>
+void KeyboardWidgetTest::benchmarkThemeSwitch(void)
+{
+	Keyboard keyboard;
+	keyboard.setKeyColor(QColor(255, 255, 255), QColor(0, 0, 0));
+	keyboard.show();
+	QVERIFY(QTest::qWaitForWindowExposed(&keyboard));
+	QCoreApplication::processEvents();
+	QBENCHMARK
+	{
+		keyboard.setKeyColor(QColor(50, 50, 50), QColor(200, 200, 200));
+		QCoreApplication::processEvents();
+		keyboard.setKeyColor(QColor(255, 255, 255), QColor(0, 0, 0));
+		QCoreApplication::processEvents();
+	}
+}
@@ -0,0 +1,245 @@
+/*
+ * LegacyKeyboardWidget.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LegacyKeyboardWidget.h"
+
+/*! Constructs LegacyKeyboardWidget. */
+LegacyKeyboardWidget::LegacyKeyboardWidget(QWidget *parent) :
+	QFrame(parent),
+	mainLayout(new QVBoxLayout(this)),
+	keyboardFrame(new QFrame(this)),
+	keyboardLayout(new QVBoxLayout(keyboardFrame)),
+	currentRow(-1),
+	currentColumn(0),
+	keyboardVisible(true)
+{
+	mainLayout->setSizeConstraint(QLayout::SetFixedSize);
+	mainLayout->setSpacing(0);
+	keyboardLayout->setSpacing(3);
+	mainLayout->setContentsMargins(0, 0, 0, 0);
+	keyboardLayout->setContentsMargins(0, 0, 0, 0);
+	keyboardFrame->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+	mainLayout->addWidget(keyboardFrame);
+	keys.clear();
+	keyLabels.clear();
+	keyMap.clear();
+	keyTypes.clear();
+	keyBaseStyleSheets.clear();
+	keyColors.clear();
+	keyFingerColors.clear();
+	// Close button
+	closeButton = new QPushButton(this);
+	setKeyboardVisible(Settings::keyboardVisible());
+	closeButton->setIconSize(QSize(32, 32));
+	closeButton->setFocusPolicy(Qt::NoFocus);
+	mainLayout->addWidget(closeButton);
+	closeButton->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+	mainLayout->setAlignment(closeButton, Qt::AlignCenter);
+	// Numeric row
+	nextRow();
+	for(int i = 0; i < 13; i++)
+		addKey();
+	addKey("⌫", Qt::Key_Backspace, 125);
+	// Above main row
+	nextRow();
+	addKey("Tab ⭾", Qt::Key_Tab, 75);
+	for(int i = 0; i < 12; i++)
+		addKey();
+	// Main row
+	nextRow();
+	addKey("Caps lock", Qt::Key_CapsLock, 100);
+	for(int i = 0; i < 12; i++)
+		addKey();
+	addKey("⏎", Qt::Key_Return, 75);
+	// Below main row
+	nextRow();
+	addKey("⇧ Shift", Qt::Key_Shift, 125);
+	for(int i = 0; i < 10; i++)
+		addKey();
+	addKey("Shift ⇧", -2, 156); // Qt doesn't recognize left and right shift; -2 is a special code for right shift
+	// Bottom row
+	nextRow();
+	addKey("Ctrl", Qt::Key_Control, 75);
+	addKey("Alt", Qt::Key_Alt, 75);
+	addKey("", Qt::Key_Space, 475);
+	addKey("Alt", Qt::Key_AltGr, 75);
+	addKey("Ctrl", -3, 103); // Qt doesn't recognize left and right control; -3 is a special code for right control
+}
+
+/*! Adds a key. */
+void LegacyKeyboardWidget::addKey(QString keyLabelText, int keyCode, int keyMinimumWidth)
+{
+	if(currentRowLayout == nullptr)
+		return;
+	if(!keyLabelText.contains("\n"))
+		keyLabelText += "\n";
+	// Create key frame
+	QFrame *newKey = new QFrame(this);
+	newKey->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+	newKey->setMinimumWidth(keyMinimumWidth);
+	newKey->setFrameShape(QFrame::WinPanel);
+	newKey->setFrameStyle(QFrame::WinPanel | QFrame::Raised);
+	KeyboardWidget::Finger finger = KeyboardWidget::keyFinger(currentColumn, currentRow);
+	QColor keyColor(0, 0, 0);
+	switch(finger)
+	{
+		case KeyboardWidget::Finger_LeftIndex:
+		case KeyboardWidget::Finger_RightIndex:
+			keyColor = QColor(255, 255, 0);
+			break;
+		case KeyboardWidget::Finger_LeftMiddle:
+		case KeyboardWidget::Finger_RightMiddle:
+			keyColor = QColor(100, 255, 0);
+			break;
+		case KeyboardWidget::Finger_LeftRing:
+		case KeyboardWidget::Finger_RightRing:
+			keyColor = QColor(0, 100, 255);
+			break;
+		case KeyboardWidget::Finger_LeftLittle:
+		case KeyboardWidget::Finger_RightLittle:
+			keyColor = QColor(255, 25, 25);
+			break;
+		default:
+			break;
+	}
+	keyBaseStyleSheets.insert(newKey, "QFrame { border-radius: 5px; }");
+	keyFingerColors.insert(newKey, keyColor);
+	newKey->setStyleSheet(keyBaseStyleSheets[newKey]);
+	currentRowLayout->addWidget(newKey);
+	keyMap.insert(QPair<int, int>(currentColumn, currentRow), newKey);
+	currentColumn++;
+	// Create key label
+	QHBoxLayout *keyLayout = new QHBoxLayout(newKey);
+	QLabel *keyLabel = new QLabel(keyLabelText, newKey);
+	keyLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+	keyLabel->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+	keyLabel->setMargin(0);
+	keyLayout->addWidget(keyLabel);
+	keyLayout->setContentsMargins(1, 1, 1, 1);
+	keyLabels.insert(newKey, keyLabel);
+	// Save the key
+	keys.insert(newKey, keyCode);
+	keyTypes.insert(newKey, 0);
+}
+
+/*! Starts a new row. */
+void LegacyKeyboardWidget::nextRow(void)
+{
+	QFrame *currentRowFrame = new QFrame(this);
+	currentRowFrame->setContentsMargins(0, 0, 0, 0);
+	currentRowFrame->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+	currentRowFrame->setFrameShape(QFrame::NoFrame);
+	currentRowFrame->setFrameStyle(QFrame::NoFrame | QFrame::Plain);
+	currentRowLayout = new QHBoxLayout(currentRowFrame);
+	currentRowLayout->setSizeConstraint(QLayout::SetFixedSize);
+	currentRowLayout->setSpacing(3);
+	currentRowLayout->setContentsMargins(0, 0, 0, 0);
+	keyboardLayout->addWidget(currentRowFrame);
+	currentRow++;
+	currentColumn = 0;
+}
+
+/*! Sets color of all keys. */
+void LegacyKeyboardWidget::setKeyColor(QColor color, QColor borderColor)
+{
+	QList<QFrame *> keyList = keys.keys();
+	for(int i = 0; i < keyList.count(); i++)
+	{
+		QColor fingerColor = keyFingerColors[keyList[i]];
+		QColor newColor = color;
+		if(!((fingerColor.red() == 0) && (fingerColor.green() == 0) && (fingerColor.blue() == 0)))
+		{
+			newColor = QColor::fromRgb(color.red() + (fingerColor.red() - color.red()) / 7.5,
+				color.green() + (fingerColor.green() - color.green()) / 7.5,
+				color.blue() + (fingerColor.blue() - color.blue()) / 7.5);
+		}
+		keyList[i]->setStyleSheet(keyBaseStyleSheets[keyList[i]]);
+		keyList[i]->setStyleSheet(keyBaseStyleSheets[keyList[i]] + "QFrame { background-color: rgb(" + QString::number(newColor.red()) + ", " + QString::number(newColor.green()) + ", " + QString::number(newColor.blue()) + "); border: 1px solid rgb(" + QString::number(borderColor.red()) + ", " + QString::number(borderColor.green()) + ", " + QString::number(borderColor.blue()) + "); }" + "QLabel { border: 0px; }");
+		keyColors[keyList[i]] = QPair<QColor, QColor>(color, borderColor);
+	}
+}
+
+/*! Resets color of a key and returns new color. */
+QColor LegacyKeyboardWidget::resetKeyColor(QFrame *targetKey)
+{
+	if(keyColors.contains(targetKey))
+	{
+		QColor color = keyColors[targetKey].first;
+		QColor borderColor = keyColors[targetKey].second;
+		QColor fingerColor = keyFingerColors[targetKey];
+		if(!((fingerColor.red() == 0) && (fingerColor.green() == 0) && (fingerColor.blue() == 0)))
+		{
+			color = QColor::fromRgb(color.red() + (fingerColor.red() - color.red()) / 7.5,
+				color.green() + (fingerColor.green() - color.green()) / 7.5,
+				color.blue() + (fingerColor.blue() - color.blue()) / 7.5);
+		}
+		targetKey->setStyleSheet(keyBaseStyleSheets[targetKey]);
+		targetKey->setStyleSheet(keyBaseStyleSheets[targetKey] + "QFrame { background-color: rgb(" + QString::number(color.red()) + ", " + QString::number(color.green()) + ", " + QString::number(color.blue()) + "); border: 1px solid rgb(" + QString::number(borderColor.red()) + ", " + QString::number(borderColor.green()) + ", " + QString::number(borderColor.blue()) + "); }" + "QLabel { border: 0px; }");
+		return color;
+	}
+	return QColor();
+}
+
+/*! Highlights a key. */
+void LegacyKeyboardWidget::highlightKey(int keyCode)
+{
+	QList<int> keyCodes = keys.values();
+	if(keyCodes.contains(keyCode))
+	{
+		QFrame *targetKey = keys.key(keyCode);
+		QColor oldColor = resetKeyColor(targetKey);
+		QColor keyBgColor = QColor(0, 175, 255);
+		keyBgColor = QColor::fromRgb(keyBgColor.red() + (oldColor.red() - keyBgColor.red()) / 1.2,
+			keyBgColor.green() + (oldColor.green() - keyBgColor.green()) / 1.2,
+			keyBgColor.blue() + (oldColor.blue() - keyBgColor.blue()) / 1.2);
+		targetKey->setStyleSheet(keyBaseStyleSheets[targetKey] + "QFrame { background-color: rgb(" + QString::number(keyBgColor.red()) + ", " + QString::number(keyBgColor.green()) + ", " + QString::number(keyBgColor.blue()) + "); }");
+	}
+}
+
+/*! Dehighlights a key. */
+void LegacyKeyboardWidget::dehighlightKey(int keyCode)
+{
+	QList<int> keyCodes = keys.values();
+	if(keyCodes.contains(keyCode))
+	{
+		QFrame *targetKey = keys.key(keyCode);
+		resetKeyColor(targetKey);
+	}
+}
+
+/*! Sets keyboard visibility. */
+void LegacyKeyboardWidget::setKeyboardVisible(bool visible, bool changeVisibility)
+{
+	if(!Settings::settingsLockEnabled())
+		Settings::setKeyboardVisible(visible);
+	if(visible)
+	{
+		closeButton->setIcon(QIcon(":/res/images/down.png"));
+		closeButton->setToolTip(tr("Hide keyboard"));
+	}
+	else
+	{
+		closeButton->setIcon(QIcon(":/res/images/up.png"));
+		closeButton->setToolTip(tr("Show keyboard"));
+	}
+	if(changeVisibility)
+		keyboardFrame->setVisible(visible);
+	keyboardVisible = visible;
+}
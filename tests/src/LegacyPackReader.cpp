@@ -0,0 +1,231 @@
+/*
+ * LegacyPackReader.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LegacyPackReader.h"
+
+/*! Returns line string of the exercise. The device must be opened in text mode. */
+QString LegacyPackReader::lineOf(QIODevice *device, int lesson, int sublesson, int exercise)
+{
+	if(!device->isReadable())
+		return "";
+	device->seek(0);
+	while(!device->atEnd())
+	{
+		QString line = QString(device->readLine()).remove('\n');
+		if((exerciseID(line, 1) == lesson) && (exerciseID(line, 2) == sublesson) && (exerciseID(line, 3) == exercise))
+			return line;
+	}
+	return "";
+}
+
+/*! Returns a part of the exercise ID (from a line).
+ *
+ * Part 1 - lesson ID\n
+ * Part 2 - sublesson ID\n
+ * Part 3 - exercise ID\n
+ */
+int LegacyPackReader::exerciseID(const QString line, const int part)
+{
+	QString out = "";
+	int i, currentPart = 0;
+	for(i = 0; i < line.count(); i++)
+	{
+		if(line[i] == '\\')
+		{
+			i++;
+			out += line[i];
+		}
+		else
+		{
+			if((line[i] == '.') || (line[i] == ' ') || (line[i] == ':'))
+			{
+				currentPart++;
+				if(currentPart == part)
+					return out.toInt();
+				out = "";
+				i++;
+			}
+			out += line[i];
+		}
+	}
+	if(currentPart + 1 == part)
+		return out.toInt();
+	else
+		return 0;
+}
+
+/*! Implementation of exerciseRepeatBool() for a config string. */
+bool LegacyPackReader::exerciseRepeatBool(const QString config)
+{
+	QString out = "";
+	int i;
+	for(i = 0; i < config.count(); i++)
+	{
+		if(config[i] == '\\')
+		{
+			i++;
+			if(i < config.count())
+				out += config[i];
+		}
+		else if(config[i] == ',')
+			return (out == "1");
+		else
+			out += config[i];
+	}
+	return "";
+}
+
+/*! Implementation of exerciseRepeatType() for a config string. */
+QString LegacyPackReader::exerciseRepeatType(const QString config)
+{
+	QString out = "";
+	bool repeatTypeReached = false;
+	int i;
+	for(i = 0; i < config.count(); i++)
+	{
+		if(config[i] == '\\')
+		{
+			i++;
+			if(i < config.count())
+				out += config[i];
+		}
+		else if(config[i] == ',')
+			repeatTypeReached = true;
+		else
+		{
+			if(repeatTypeReached)
+				out += config[i];
+		}
+	}
+	return out;
+}
+
+/*! Gets config string from a line. */
+QString LegacyPackReader::exerciseRepeatConfig(const QString line)
+{
+	QString out = "";
+	bool repeatConfigReached = false;
+	int i;
+	for(i = 0; i < line.count(); i++)
+	{
+		if(line[i] == '\\')
+		{
+			i++;
+			if(i < line.count())
+				out += line[i];
+		}
+		else if(line[i] == ':')
+			repeatConfigReached = true;
+		else if((line[i] == ' ') || (line[i] == ';'))
+			return out;
+		else
+		{
+			if(repeatConfigReached)
+				out += line[i];
+		}
+	}
+	return out;
+}
+
+/*! Gets a specific exercise attribute from a config string. */
+QString LegacyPackReader::exerciseAttribute(const QString config, const int id)
+{
+	QString out = "";
+	int i, currentID = 0;
+	for(i = 0; i < config.count(); i++)
+	{
+		if(config[i] == '\\')
+		{
+			i++;
+			if(i < config.count())
+				out += config[i];
+		}
+		else if(config[i] == ',')
+		{
+			if(currentID == id)
+				return out;
+			out = "";
+			currentID++;
+		}
+		else
+			out += config[i];
+	}
+	if(currentID == id)
+		return out;
+	else
+		return "";
+}
+
+/*! Gets a config string from a line. */
+QString LegacyPackReader::exerciseAttributes(const QString line)
+{
+	QString out = "";
+	bool lengthConfigReached = false;
+	int i;
+	for(i = 0; i < line.count(); i++)
+	{
+		if(line[i] == '\\')
+		{
+			i++;
+			if(i < line.count())
+				out += '\\' + line[i];
+		}
+		else if(line[i] == ';')
+			lengthConfigReached = true;
+		else if(line[i] == ' ')
+			return out;
+		else
+		{
+			if(lengthConfigReached)
+				out += line[i];
+		}
+	}
+	return out;
+}
+
+/*! Implementation of exerciseRawText() for a line. */
+QString LegacyPackReader::exerciseRawText(const QString line)
+{
+	QString out = "";
+	bool textReached = false;
+	int i;
+	for(i = 0; i < line.count(); i++)
+	{
+		if(line[i] == '\\')
+		{
+			i++;
+			if(i < line.count())
+			{
+				if(line[i] == 'n')
+					out += "\\n";
+				else if(textReached)
+					out += line[i];
+			}
+		}
+		else if((line[i] == ' ') && !textReached)
+			textReached = true;
+		else
+		{
+			if(textReached)
+				out += line[i];
+		}
+	}
+	return out;
+}
@@ -0,0 +1,271 @@
+/*
+ * StringUtilsTest.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "StringUtilsTest.h"
+#include "LegacyStringUtils.h"
+#include "AllocationCounter.h"
+
+void StringUtilsTest::sameAsLegacy_data(void)
+{
+	QTest::addColumn<QString>("exerciseText");
+	QTest::addColumn<QString>("input");
+	QTest::addColumn<int>("mistakeChars");
+	QString text = "The quick brown fox jumps over the lazy dog.";
+	QTest::newRow("correct") << text << text << 0;
+	QTest::newRow("changed word") << text << "The quikc brown fox jumps over the lazy dog." << 0;
+	QTest::newRow("split word") << text << "The qui ck brown fox jumps over the lazy dog." << 0;
+	QTest::newRow("split words") << text << "The qu ick brown fox ju mps over the la zy dog." << 0;
+	QTest::newRow("deleted space") << text << "The quickbrown fox jumps over the lazy dog." << 0;
+	QTest::newRow("deleted spaces") << text << "The quickbrown fox jumpsover thelazy dog." << 0;
+	QTest::newRow("merged changed words") << text << "The quick brown fox jumps overteh lazy dog." << 0;
+	QTest::newRow("merged words with a mistake") << text << "The quickbrwn fox jumps over the lazy dog." << 0;
+	QTest::newRow("deleted space before punctuation") << "Hello, world. How are you?" << "Hello,world. How are you ?" << 0;
+	QTest::newRow("repeated words") << "the cat and the dog and the bird" << "the cat the and the dog and and the bird" << 0;
+	QTest::newRow("deleted repeated word") << "one one one two one" << "one one two one" << 0;
+	QTest::newRow("added repeated word") << "one two one two" << "one two one one two" << 0;
+	QTest::newRow("tie of words") << "one two" << "two one" << 0;
+	QTest::newRow("tie of alternating words") << "a b a b a" << "b a b a b" << 0;
+	QTest::newRow("tie of characters") << "abcd efgh" << "acbd egfh" << 0;
+	QTest::newRow("missing words") << text << "The quick fox over the dog." << 0;
+	QTest::newRow("added words") << text << "The very quick brown fox jumps over over the lazy dog." << 0;
+	QTest::newRow("multiple lines") << "first line\nsecond line\nthird line" << "firstline\nsecond lime\nthirdline" << 0;
+	QTest::newRow("mistake limit") << text << "Teh qiuck bronw fox jmups oevr the lazy dgo." << 6;
+	QTest::newRow("no mistake limit") << text << "Teh qiuck bronw fox jmups oevr the lazy dgo." << 0;
+	QTest::newRow("unfinished") << text << "The quikc brown fo" << 0;
+}
+
+/*! Checks that StringUtils#validateExercise() finds the same mistakes as LegacyStringUtils#validateExercise(). */
+void StringUtilsTest::sameAsLegacy(void)
+{
+	QFETCH(QString, exerciseText);
+	QFETCH(QString, input);
+	QFETCH(int, mistakeChars);
+	QVector<QPair<QString, int>> characters = recordedCharacters(input);
+	int totalHits = 0, mistakeCount = 0;
+	QStringList errorWords;
+	MistakeList mistakes = StringUtils::validateExercise(exerciseText, input, characters, &totalHits, &mistakeCount, &errorWords, false, 0, mistakeChars);
+	int legacyTotalHits = 0, legacyMistakeCount = 0;
+	QStringList legacyErrorWords;
+	QList<QVariantMap> legacyMistakes = LegacyStringUtils::validateExercise(exerciseText, input, characters, &legacyTotalHits, &legacyMistakeCount, &legacyErrorWords, false, 0, mistakeChars);
+	QCOMPARE(mistakeList(mistakes), mistakeList(legacyMistakes));
+	QCOMPARE(totalHits, legacyTotalHits);
+	QCOMPARE(mistakeCount, legacyMistakeCount);
+	QCOMPARE(errorWords, legacyErrorWords);
+}
+
+void StringUtilsTest::validationAllocations_data(void)
+{
+	QTest::addColumn<bool>("legacy");
+	QTest::newRow("legacy") << true;
+	QTest::newRow("typed") << false;
+}
+
+/*! Reports the number of heap allocations made by the validation of an exercise with a few mistakes. */
+void StringUtilsTest::validationAllocations(void)
+{
+	if(!AllocationCounter::isSupported())
+		QSKIP("Allocations can be counted only with the GNU C library");
+	QFETCH(bool, legacy);
+	QString exerciseText = "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs.\n"
+						   "How vexingly quick daft zebras jump! Sphinx of black quartz, judge my vow.";
+	QString input = "The quikc brown fox jumps overthe lazy dog. Pack my box with five dozen liquor jugs.\n"
+					"How vexingly quick daft zebras jump! Sphinx of black quartz, judge my vow.";
+	QVector<QPair<QString, int>> characters = recordedCharacters(input);
+	int totalHits, mistakeCount;
+	QStringList errorWords;
+	AllocationCounter::start();
+	if(legacy)
+		LegacyStringUtils::validateExercise(exerciseText, input, characters, &totalHits, &mistakeCount, &errorWords, false, 0, 6);
+	else
+		StringUtils::validateExercise(exerciseText, input, characters, &totalHits, &mistakeCount, &errorWords, false, 0, 6);
+	qint64 allocations = AllocationCounter::stop();
+	QVERIFY(mistakeCount > 0);
+	QTest::setBenchmarkResult(allocations, QTest::Events);
+}
+
+/*!
+ * Compares StringUtils#alignPrefixDistancesBanded() with the full table on random texts and bands.\n
+ * Distances within the band must be correct and the other distances must not be lower.
+ * If the lowest distance fits in the band, the same beginnings of the text must have it.
+ */
+void StringUtilsTest::bandedAlignment(void)
+{
+	std::mt19937 generator(1);
+	for(int i = 0; i < bandedAlignmentCases; i++)
+	{
+		QString text = randomText(generator, std::uniform_int_distribution<int>(0, 60)(generator));
+		QString input = randomEdits(generator, text.left(std::uniform_int_distribution<int>(0, text.count())(generator)), std::uniform_int_distribution<int>(0, 12)(generator));
+		int band = std::uniform_int_distribution<int>(1, 16)(generator);
+		const QVector<int> expected = prefixDistances(text, input);
+		const QVector<int> distances = StringUtils::alignPrefixDistancesBanded(text, input, band);
+		QCOMPARE(distances.count(), expected.count());
+		for(int j = 0; j < distances.count(); j++)
+		{
+			if(expected[j] <= band)
+				QCOMPARE(distances[j], expected[j]);
+			else
+				QVERIFY(distances[j] >= expected[j]);
+		}
+		int minDistance = *std::min_element(distances.constBegin(), distances.constEnd());
+		if(minDistance <= band)
+		{
+			QCOMPARE(minDistance, *std::min_element(expected.constBegin(), expected.constEnd()));
+			for(int j = 0; j < distances.count(); j++)
+				QCOMPARE(distances[j] == minDistance, expected[j] == minDistance);
+		}
+	}
+}
+
+void StringUtilsTest::adaptiveAlignment_data(void)
+{
+	QTest::addColumn<int>("length");
+	QTest::addColumn<int>("edits");
+	QTest::newRow("close") << 1500 << 20;
+	QTest::newRow("distant") << 1200 << 300;
+	QTest::newRow("unrelated") << 1100 << -1;
+}
+
+/*! Checks that StringUtils#alignPrefix() returns the same beginning as the full table when the band is used. */
+void StringUtilsTest::adaptiveAlignment(void)
+{
+	QFETCH(int, length);
+	QFETCH(int, edits);
+	std::mt19937 generator(length);
+	QString text = randomText(generator, 3 * length);
+	QString input;
+	if(edits == -1)
+		input = randomText(generator, length);
+	else
+		input = randomEdits(generator, text.left(length), edits);
+	int bandWidth = 0;
+	int prefix = StringUtils::alignPrefix(text, input, &bandWidth);
+	const QVector<int> expected = prefixDistances(text, input);
+	int expectedPrefix = 0;
+	for(int i = 1; i < expected.count(); i++)
+	{
+		if(expected[i] <= expected[expectedPrefix])
+			expectedPrefix = i;
+	}
+	QCOMPARE(prefix, expectedPrefix);
+	QVERIFY(bandWidth > 0);
+	if(edits == 20)
+		QVERIFY(bandWidth < input.count());
+}
+
+/*! Returns the recorded characters of the input (every character is one hit). */
+QVector<QPair<QString, int>> StringUtilsTest::recordedCharacters(const QString input)
+{
+	QVector<QPair<QString, int>> out;
+	for(int i = 0; i < input.count(); i++)
+		out += QPair<QString, int>(QString(input[i]), 1);
+	return out;
+}
+
+/*! Returns the mistakes as a list of variant maps, so that they can be compared. */
+QVariantList StringUtilsTest::mistakeList(const MistakeList &mistakes)
+{
+	QVariantList out;
+	for(int i = 0; i < mistakes.count(); i++)
+		out += mistakes[i].toVariantMap();
+	return out;
+}
+
+/*! Returns the legacy mistakes in the same format as mistakeList(). Missing keys have the default values of Mistake. */
+QVariantList StringUtilsTest::mistakeList(const QList<QVariantMap> &legacyMistakes)
+{
+	QVariantList out;
+	for(int i = 0; i < legacyMistakes.count(); i++)
+	{
+		const QVariantMap map = legacyMistakes[i];
+		Mistake mistake;
+		mistake.pos = map.value("pos").toInt();
+		QString type = map.value("type").toString();
+		if(type == "deletion")
+			mistake.type = Mistake::Type_Deletion;
+		else if(type == "addition")
+			mistake.type = Mistake::Type_Addition;
+		else
+			mistake.type = Mistake::Type_Change;
+		mistake.previous = map.value("previous").toString();
+		mistake.previousPos = map.value("previousPos", -1).toInt();
+		mistake.merged = map.value("merged").toBool();
+		mistake.disable = map.value("disable").toBool();
+		out += mistake.toVariantMap();
+	}
+	return out;
+}
+
+/*! Returns a random text with a few different characters, so that there are many equally good alignments. */
+QString StringUtilsTest::randomText(std::mt19937 &generator, int length)
+{
+	const QString characters = "ab c";
+	std::uniform_int_distribution<int> distribution(0, characters.count() - 1);
+	QString out;
+	for(int i = 0; i < length; i++)
+		out += characters[distribution(generator)];
+	return out;
+}
+
+/*! Returns the text with count random insertions, deletions and substitutions. */
+QString StringUtilsTest::randomEdits(std::mt19937 &generator, const QString text, int count)
+{
+	QString out = text;
+	for(int i = 0; i < count; i++)
+	{
+		int pos = std::uniform_int_distribution<int>(0, out.count())(generator);
+		QString character = randomText(generator, 1);
+		switch(std::uniform_int_distribution<int>(0, 2)(generator))
+		{
+			case 0:
+				out.insert(pos, character);
+				break;
+			case 1:
+				out.remove(pos, 1);
+				break;
+			default:
+				out.replace(pos, 1, character);
+				break;
+		}
+	}
+	return out;
+}
+
+/*!
+ * Returns the edit distance between input and every beginning of text using the full table.\n
+ * Like StringUtils#alignPrefixDistances(), beginnings longer than 2 * input length are skipped.
+ */
+QVector<int> StringUtilsTest::prefixDistances(const QString text, const QString input)
+{
+	int length = std::min(text.count(), 2 * input.count());
+	QVector<QVector<int>> table(input.count() + 1, QVector<int>(length + 1));
+	for(int i = 0; i <= length; i++)
+		table[0][i] = i;
+	for(int j = 1; j <= input.count(); j++)
+	{
+		table[j][0] = j;
+		for(int i = 1; i <= length; i++)
+		{
+			int substitution = table[j - 1][i - 1] + (text[i - 1] == input[j - 1] ? 0 : 1);
+			table[j][i] = std::min(substitution, std::min(table[j - 1][i], table[j][i - 1]) + 1);
+		}
+	}
+	return table[input.count()];
+}
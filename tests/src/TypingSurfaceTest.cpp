@@ -0,0 +1,222 @@
+/*
+ * TypingSurfaceTest.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFontDatabase>
+#include <QVBoxLayout>
+#include <QScrollBar>
+#include "TypingSurfaceTest.h"
+
+void TypingSurfaceTest::perKey_data(void)
+{
+	addViewRows();
+}
+
+/*!
+ * Measures the time it takes to update the widgets when a character is typed and deleted (2 key presses).\n
+ * The widgets are repainted later by the event loop, so painting isn't included (see perKeyLatency()).
+ */
+void TypingSurfaceTest::perKey(void)
+{
+	QFETCH(bool, surface);
+	QFETCH(int, length);
+	const QString text = typedText(length);
+	const QString typed = text + "x";
+	const QString underline = underlineText(text);
+	const QString typedUnderline = underlineText(typed);
+	View view;
+	QVERIFY(initView(&view, surface, text));
+	QBENCHMARK
+	{
+		setViewText(&view, typed, typedUnderline);
+		setViewText(&view, text, underline);
+	}
+}
+
+void TypingSurfaceTest::frame_data(void)
+{
+	addViewRows();
+}
+
+/*! Measures the time it takes to paint the visible part of the text (one frame). */
+void TypingSurfaceTest::frame(void)
+{
+	QFETCH(bool, surface);
+	QFETCH(int, length);
+	View view;
+	QVERIFY(initView(&view, surface, typedText(length)));
+	QBENCHMARK
+	{
+		view.scrollArea.viewport()->repaint();
+	}
+}
+
+void TypingSurfaceTest::perKeyLatency_data(void)
+{
+	addViewRows();
+}
+
+/*!
+ * Measures the time it takes to show a typed and a deleted character (2 key presses).\n
+ * This includes updating the widgets and painting the changed parts.
+ */
+void TypingSurfaceTest::perKeyLatency(void)
+{
+	QFETCH(bool, surface);
+	QFETCH(int, length);
+	const QString text = typedText(length);
+	const QString typed = text + "x";
+	const QString underline = underlineText(text);
+	const QString typedUnderline = underlineText(typed);
+	View view;
+	QVERIFY(initView(&view, surface, text));
+	QBENCHMARK
+	{
+		setViewText(&view, typed, typedUnderline);
+		QCoreApplication::processEvents();
+		setViewText(&view, text, underline);
+		QCoreApplication::processEvents();
+	}
+}
+
+/*! Adds rows with both widget stacks and different text lengths. */
+void TypingSurfaceTest::addViewRows(void)
+{
+	QTest::addColumn<bool>("surface");
+	QTest::addColumn<int>("length");
+	const QList<int> lengths = { 100, 1000, 10000 };
+	for(int i = 0; i < lengths.count(); i++)
+	{
+		QTest::newRow(qPrintable(QString("TextView %1").arg(lengths[i]))) << false << lengths[i];
+		QTest::newRow(qPrintable(QString("TypingSurface %1").arg(lengths[i]))) << true << lengths[i];
+	}
+}
+
+/*!
+ * Creates TypingSurface (or the TextView stack used before) in the scroll area, sets the text and shows it.\n
+ * Returns false if the window isn't exposed.
+ */
+bool TypingSurfaceTest::initView(View *view, bool surface, const QString text)
+{
+	const QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+	QWidget *contents = new QWidget;
+	QVBoxLayout *layout = new QVBoxLayout(contents);
+	layout->setContentsMargins(0, 0, 0, 0);
+	if(surface)
+	{
+		view->surface = new TypingSurface(contents);
+		view->surface->setTextFont(font);
+		view->surface->setCorrectionsVisible(false);
+		layout->addWidget(view->surface, 0, Qt::AlignTop);
+	}
+	else
+	{
+		view->inputView = new TextView(contents);
+		view->mistakeView = new TextView(view->inputView);
+		view->inputView->setFont(font);
+		view->mistakeView->setFont(font);
+		view->mistakeView->setHorizontalAdjust(false);
+		layout->addWidget(view->inputView, 0, Qt::AlignTop);
+	}
+	setViewText(view, text, underlineText(text));
+	view->scrollArea.setWidgetResizable(true);
+	view->scrollArea.setWidget(contents);
+	view->scrollArea.resize(800, 600);
+	view->scrollArea.show();
+	if(!QTest::qWaitForWindowExposed(&view->scrollArea))
+		return false;
+	QCoreApplication::processEvents();
+	view->scrollArea.verticalScrollBar()->setValue(view->scrollArea.verticalScrollBar()->maximum());
+	QCoreApplication::processEvents();
+	return true;
+}
+
+/*! Sets the typed text in the same way as the main window does on every key press. */
+void TypingSurfaceTest::setViewText(View *view, const QString text, const QString underlineText)
+{
+	if(view->surface)
+	{
+		QVector<TypingSurface::Line> lines = surfaceLines(text, underlineText);
+		view->surface->setLines(lines);
+		view->surface->setCursorPosition(lines.count() - 1, lines.last().text.count());
+	}
+	else
+	{
+		view->inputView->setHtml(textViewHtml(text));
+		view->mistakeView->setHtml(textViewHtml(underlineText));
+	}
+}
+
+/*! Returns a text with the length, which consists of lines with 60 characters. */
+QString TypingSurfaceTest::typedText(int length)
+{
+	const QString sentence = "The quick brown fox jumps over the lazy dog. ";
+	QString out;
+	while(out.count() < length)
+	{
+		if((out.count() % 61) == 60)
+			out += '\n';
+		else
+			out += sentence[out.count() % sentence.count()];
+	}
+	return out;
+}
+
+/*! Returns the underline text of the typed text, which has a mistake in every 20 characters. */
+QString TypingSurfaceTest::underlineText(const QString text)
+{
+	QString out;
+	for(int i = 0; i < text.count(); i++)
+	{
+		if(text[i] == '\n')
+			out += '\n';
+		else
+			out += (i % 20 == 0) ? '_' : ' ';
+	}
+	return out;
+}
+
+/*! Returns the text in the HTML format set to TextView before TypingSurface was used. */
+QString TypingSurfaceTest::textViewHtml(const QString text)
+{
+	return text.toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "<br>");
+}
+
+/*! Returns lines of TypingSurface in the same way as MainWindow#updateInputSurface(). */
+QVector<TypingSurface::Line> TypingSurfaceTest::surfaceLines(const QString text, const QString underlineText)
+{
+	const QStringList textLines = text.split('\n');
+	const QStringList underlineLines = underlineText.split('\n');
+	QVector<TypingSurface::Line> lines;
+	for(int i = 0; i < textLines.count(); i++)
+	{
+		TypingSurface::Line line;
+		line.text = textLines[i];
+		if(i < underlineLines.count())
+		{
+			for(int j = 0; j < underlineLines[i].count(); j++)
+			{
+				if(underlineLines[i][j] == '_')
+					line.underlines += QPair<int, int>(j, 1);
+			}
+		}
+		lines += line;
+	}
+	return lines;
+}
@@ -0,0 +1,49 @@
+/*
+ * AllocationCounter.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/*!
+ * \brief The AllocationCounter class counts heap allocations.
+ *
+ * The test executable replaces malloc(), calloc() and realloc() of the GNU C library,
+ * so allocations made by Qt and libcore are counted too (operator new uses malloc()).\n
+ * Counting is available only if isSupported() returns true.
+ *
+ * Example usage:
+ * \code
+ * AllocationCounter::start();
+ * // ...
+ * qint64 allocations = AllocationCounter::stop();
+ * \endcode
+ */
+class AllocationCounter
+{
+	public:
+		static bool isSupported(void);
+		static void start(void);
+		static qint64 stop(void);
+		static void add(void);
+};
+
+#endif // ALLOCATIONCOUNTER_H
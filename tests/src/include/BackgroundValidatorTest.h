@@ -0,0 +1,43 @@
+/*
+ * BackgroundValidatorTest.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BACKGROUNDVALIDATORTEST_H
+#define BACKGROUNDVALIDATORTEST_H
+
+#include <QtTest>
+#include "BackgroundValidator.h"
+
+/*!
+ * \brief The BackgroundValidatorTest class checks that BackgroundValidator returns the same result as StringUtils#validateExercise().
+ *
+ * Keystrokes are passed to the validator one by one. '\b' in the typed text is a backspace.
+ */
+class BackgroundValidatorTest : public QObject
+{
+		Q_OBJECT
+	private slots:
+		void sameAsBatch_data(void);
+		void sameAsBatch(void);
+
+	private:
+		static QVariantList mistakeList(const MistakeList &mistakes);
+};
+
+#endif // BACKGROUNDVALIDATORTEST_H
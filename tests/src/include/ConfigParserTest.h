@@ -0,0 +1,64 @@
+/*
+ * ConfigParserTest.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONFIGPARSERTEST_H
+#define CONFIGPARSERTEST_H
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include "ConfigParser.h"
+
+/*!
+ * \brief The ConfigParserTest class contains tests and benchmarks of ConfigParser.
+ *
+ * ConfigParser#parseExerciseLine() is compared with the separate field functions used before (see LegacyPackReader).\n
+ * The large pack benchmarks use a 50 MB synthetic pack, which is created in initTestCase().
+ * They compare mapped packs with packs loaded to a buffer (see ConfigParser#loadToBuffer())
+ * and with the pack reader used before packs were indexed (see LegacyPackReader).
+ */
+class ConfigParserTest : public QObject
+{
+		Q_OBJECT
+	private slots:
+		void initTestCase(void);
+		void parseExerciseLine_data(void);
+		void parseExerciseLine(void);
+		void parseLines_data(void);
+		void parseLines(void);
+		void textCache(void);
+		void largePackMemory_data(void);
+		void largePackMemory(void);
+		void largePackOpen_data(void);
+		void largePackOpen(void);
+		void largePackQuery_data(void);
+		void largePackQuery(void);
+
+	private:
+		static const qint64 largePackSize = 50 * 1024 * 1024;
+		QTemporaryDir tempDir;
+		QString largePackFileName;
+		int lastLesson = 0, lastSublesson = 0, lastExercise = 0;
+		QString lastRawText;
+		static QStringList sampleLines(void);
+		static QString exerciseRawText(int lesson, int sublesson, int exercise);
+		static qint64 heapUsage(void);
+};
+
+#endif // CONFIGPARSERTEST_H
@@ -0,0 +1,58 @@
+/*
+ * KeyboardWidgetTest.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYBOARDWIDGETTEST_H
+#define KEYBOARDWIDGETTEST_H
+
+#include <QtTest>
+#include "widgets/KeyboardWidget.h"
+#include "LegacyKeyboardWidget.h"
+
+/*!
+ * \brief The KeyboardWidgetTest class contains benchmarks of KeyboardWidget.
+ *
+ * KeyboardWidget (keys painted by KeyboardView) is compared with LegacyKeyboardWidget (a widget with a style sheet for every key).
+ */
+class KeyboardWidgetTest : public QObject
+{
+		Q_OBJECT
+	private slots:
+		void highlight_data(void);
+		void highlight(void);
+		void construction_data(void);
+		void construction(void);
+		void objectCount_data(void);
+		void objectCount(void);
+		void themeSwitch_data(void);
+		void themeSwitch(void);
+
+	private:
+		static void addKeyboardRows(void);
+		template<typename Keyboard>
+		static void benchmarkHighlight(void);
+		template<typename Keyboard>
+		static void benchmarkConstruction(void);
+		template<typename Keyboard>
+		static void benchmarkObjectCount(void);
+		template<typename Keyboard>
+		static void benchmarkThemeSwitch(void);
+};
+
+#endif // KEYBOARDWIDGETTEST_H
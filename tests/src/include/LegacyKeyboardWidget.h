@@ -0,0 +1,69 @@
+/*
+ * LegacyKeyboardWidget.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEGACYKEYBOARDWIDGET_H
+#define LEGACYKEYBOARDWIDGET_H
+
+#include <QFrame>
+#include <QLayout>
+#include <QLabel>
+#include <QMap>
+#include <QPushButton>
+#include "Settings.h"
+#include "widgets/KeyboardWidget.h"
+
+/*!
+ * \brief The LegacyKeyboardWidget class is the KeyboardWidget before keys were painted by KeyboardView.
+ *
+ * It's used as a reference in KeyboardWidgetTest.
+ * Every row and every key is a QFrame with a layout, key labels are QLabels and keys are colored using style sheets.\n
+ * Only the default keys are created, layouts can't be loaded and the close button isn't connected.
+ */
+class LegacyKeyboardWidget : public QFrame
+{
+		Q_OBJECT
+	public:
+		explicit LegacyKeyboardWidget(QWidget *parent = nullptr);
+		void setKeyColor(QColor color, QColor borderColor);
+		void highlightKey(int keyCode);
+		void dehighlightKey(int keyCode);
+		void setKeyboardVisible(bool visible, bool changeVisibility = true);
+
+	private:
+		QVBoxLayout *mainLayout;
+		QFrame *keyboardFrame;
+		QVBoxLayout *keyboardLayout;
+		QPushButton *closeButton;
+		QMultiMap<QFrame *, int> keys;
+		QMap<QFrame *, QLabel *> keyLabels;
+		QMap<QFrame *, int> keyTypes;
+		QMap<QPair<int, int>, QFrame *> keyMap;
+		int currentRow, currentColumn;
+		QHBoxLayout *currentRowLayout = nullptr;
+		QMap<QFrame *, QString> keyBaseStyleSheets;
+		QMap<QFrame *, QPair<QColor, QColor>> keyColors;
+		QMap<QFrame *, QColor> keyFingerColors;
+		void addKey(QString keyLabelText = "", int keyCode = -1, int keyMinimumWidth = 50);
+		void nextRow(void);
+		QColor resetKeyColor(QFrame *targetKey);
+		bool keyboardVisible;
+};
+
+#endif // LEGACYKEYBOARDWIDGET_H
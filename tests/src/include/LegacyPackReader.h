@@ -0,0 +1,47 @@
+/*
+ * LegacyPackReader.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEGACYPACKREADER_H
+#define LEGACYPACKREADER_H
+
+#include <QIODevice>
+#include <QString>
+
+/*!
+ * \brief The LegacyPackReader class contains the pack reading functions of ConfigParser before packs were indexed.
+ *
+ * It's used as a reference in ConfigParserTest benchmarks.
+ * Every query reads the pack line by line from the beginning
+ * and every field of an exercise line is read by a separate function.
+ */
+class LegacyPackReader
+{
+	public:
+		static QString lineOf(QIODevice *device, int lesson, int sublesson, int exercise);
+		static int exerciseID(const QString line, const int part);
+		static bool exerciseRepeatBool(const QString config);
+		static QString exerciseRepeatType(const QString config);
+		static QString exerciseRepeatConfig(const QString line);
+		static QString exerciseAttribute(const QString config, const int id);
+		static QString exerciseAttributes(const QString line);
+		static QString exerciseRawText(const QString line);
+};
+
+#endif // LEGACYPACKREADER_H
@@ -0,0 +1,50 @@
+/*
+ * LegacyStringUtils.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEGACYSTRINGUTILS_H
+#define LEGACYSTRINGUTILS_H
+
+#include <QVariantMap>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+
+/*!
+ * \brief The LegacyStringUtils class contains the exercise validation functions of StringUtils before mistakes were stored in a MistakeList.
+ *
+ * It's used as a reference in StringUtilsTest.
+ * Mistakes are variant maps with "pos", "type", "previous", "previousPos", "merged" and "disable" keys
+ * and lists are compared using the full longest common subsequence table.\n
+ * The mistake limit is passed as a parameter (0 means no limit), so that settings aren't needed.
+ */
+class LegacyStringUtils
+{
+	public:
+		static int lcsLen(QList<QVariant> source, QList<QVariant> target, QMap<int, QMap<int, int>> *lcsTable);
+		static QList<QVariant> longestCommonSubsequence(QList<QVariant> source, QList<QVariant> target);
+		static QList<QVariantMap> compareLists(QList<QVariant> source, QList<QVariant> target, QVector<QPair<QString, int>> *recordedCharacters = nullptr, int *hits = nullptr, int *inputPos = nullptr);
+		static QList<QVariantMap> compareStrings(QString source, QString target, QVector<QPair<QString, int>> *recordedCharacters = nullptr, int *hits = nullptr, int *inputPos = nullptr);
+		static QStringList splitWordsByPunct(QStringList source);
+		static QMap<int, QVariantMap> generateDiffList(QStringList *sourceWords, QStringList *targetWords, QList<int> *mergeList = nullptr);
+		static QList<QVariantMap> findMistakes(QString exerciseText, QString input, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, QStringList *errorWords, int mistakeChars);
+		static QList<QVariantMap> validateExercise(QString exerciseText, QString inputText, QVector<QPair<QString, int>> recordedCharacters, int *totalHits, int *mistakeCount, QStringList *errorWords, bool timed, int timeSecs, int mistakeChars);
+};
+
+#endif // LEGACYSTRINGUTILS_H
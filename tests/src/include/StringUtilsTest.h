@@ -0,0 +1,57 @@
+/*
+ * StringUtilsTest.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRINGUTILSTEST_H
+#define STRINGUTILSTEST_H
+
+#include <random>
+#include <QtTest>
+#include "StringUtils.h"
+
+/*!
+ * \brief The StringUtilsTest class contains tests and benchmarks of exercise validation in StringUtils.
+ *
+ * The validation functions are compared with the functions used before mistakes were stored in a MistakeList (see LegacyStringUtils).\n
+ * The mistakes found in split, merged and repeated words must be the same as before, including the choice between equally long alignments.\n
+ * The banded prefix alignment is compared with the full table on random texts (see StringUtils#alignPrefix()).
+ */
+class StringUtilsTest : public QObject
+{
+		Q_OBJECT
+	private slots:
+		void sameAsLegacy_data(void);
+		void sameAsLegacy(void);
+		void validationAllocations_data(void);
+		void validationAllocations(void);
+		void bandedAlignment(void);
+		void adaptiveAlignment_data(void);
+		void adaptiveAlignment(void);
+
+	private:
+		static const int bandedAlignmentCases = 20000;
+		static QVector<QPair<QString, int>> recordedCharacters(const QString input);
+		static QString randomText(std::mt19937 &generator, int length);
+		static QString randomEdits(std::mt19937 &generator, const QString text, int count);
+		static QVector<int> prefixDistances(const QString text, const QString input);
+		static QVariantList mistakeList(const MistakeList &mistakes);
+		static QVariantList mistakeList(const QList<QVariantMap> &legacyMistakes);
+};
+
+#endif // STRINGUTILSTEST_H
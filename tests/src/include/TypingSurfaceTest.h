@@ -0,0 +1,66 @@
+/*
+ * TypingSurfaceTest.h
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TYPINGSURFACETEST_H
+#define TYPINGSURFACETEST_H
+
+#include <QtTest>
+#include <QScrollArea>
+#include "widgets/TypingSurface.h"
+#include "widgets/TextView.h"
+
+/*!
+ * \brief The TypingSurfaceTest class contains benchmarks of TypingSurface.
+ *
+ * TypingSurface is compared with the widgets used before to show typed text: a TextView with the input
+ * and a TextView with underlined mistakes on top of it, both set using HTML on every key press.\n
+ * The benchmarks use input texts of different lengths (lines have 60 characters, like a wrapped exercise).
+ * The widgets are in an 800x600 scroll area scrolled to the end of the text, like in the main window.
+ */
+class TypingSurfaceTest : public QObject
+{
+		Q_OBJECT
+	private slots:
+		void perKey_data(void);
+		void perKey(void);
+		void frame_data(void);
+		void frame(void);
+		void perKeyLatency_data(void);
+		void perKeyLatency(void);
+
+	private:
+		struct View
+		{
+				QScrollArea scrollArea;
+				TypingSurface *surface = nullptr;
+				TextView *inputView = nullptr;
+				TextView *mistakeView = nullptr;
+		};
+
+		static void addViewRows(void);
+		static bool initView(View *view, bool surface, const QString text);
+		static void setViewText(View *view, const QString text, const QString underlineText);
+		static QString typedText(int length);
+		static QString underlineText(const QString text);
+		static QString textViewHtml(const QString text);
+		static QVector<TypingSurface::Line> surfaceLines(const QString text, const QString underlineText);
+};
+
+#endif // TYPINGSURFACETEST_H
@@ -0,0 +1,52 @@
+/*
+ * main.cpp
+ * This file is part of Open-Typer
+ *
+ * Copyright (C) 2022 - adazem009
+ *
+ * Open-Typer is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Open-Typer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Open-Typer. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QStandardPaths>
+#include "Settings.h"
+#include "BackgroundValidatorTest.h"
+#include "ConfigParserTest.h"
+#include "KeyboardWidgetTest.h"
+#include "StringUtilsTest.h"
+#include "TypingSurfaceTest.h"
+
+/*! Runs all tests. Returns non-zero if any of them fails. */
+int main(int argc, char *argv[])
+{
+	// Widgets are created in benchmarks, they don't have to be shown on a screen
+	if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication a(argc, argv);
+	// Widgets read and write settings, don't use the user's configuration
+	QStandardPaths::setTestModeEnabled(true);
+	Settings::init();
+	int status = 0;
+	BackgroundValidatorTest backgroundValidatorTest;
+	status |= QTest::qExec(&backgroundValidatorTest, argc, argv);
+	ConfigParserTest configParserTest;
+	status |= QTest::qExec(&configParserTest, argc, argv);
+	KeyboardWidgetTest keyboardWidgetTest;
+	status |= QTest::qExec(&keyboardWidgetTest, argc, argv);
+	StringUtilsTest stringUtilsTest;
+	status |= QTest::qExec(&stringUtilsTest, argc, argv);
+	TypingSurfaceTest typingSurfaceTest;
+	status |= QTest::qExec(&typingSurfaceTest, argc, argv);
+	return status;
+}
@@ -0,0 +1,41 @@
+QT += core gui widgets testlib concurrent
+CONFIG += console c++11 testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = libcore-tests
+
+INCLUDEPATH += \
+    src/include \
+    ../libcore/src/include \
+    ../app/src/include
+
+LIBS += -L$$_PRO_FILE_PWD_/.. -lopentyper-core
+unix: QMAKE_RPATHDIR += $$_PRO_FILE_PWD_/..
+
+SOURCES += \
+    src/main.cpp \
+    ../app/src/widgets/KeyboardView.cpp \
+    ../app/src/widgets/KeyboardWidget.cpp \
+    src/AllocationCounter.cpp \
+    src/BackgroundValidatorTest.cpp \
+    src/ConfigParserTest.cpp \
+    src/KeyboardWidgetTest.cpp \
+    src/LegacyKeyboardWidget.cpp \
+    src/LegacyPackReader.cpp \
+    src/LegacyStringUtils.cpp \
+    src/StringUtilsTest.cpp \
+    src/TypingSurfaceTest.cpp
+
+HEADERS += \
+    ../app/src/include/widgets/KeyboardView.h \
+    ../app/src/include/widgets/KeyboardWidget.h \
+    src/include/AllocationCounter.h \
+    src/include/BackgroundValidatorTest.h \
+    src/include/ConfigParserTest.h \
+    src/include/KeyboardWidgetTest.h \
+    src/include/LegacyKeyboardWidget.h \
+    src/include/LegacyPackReader.h \
+    src/include/LegacyStringUtils.h \
+    src/include/StringUtilsTest.h \
+    src/include/TypingSurfaceTest.h